@@ -23,6 +23,12 @@ class Hal:
         self.hydra.build()
         self.is_built = True
         
+    def extend(self):
+        """extend the built hydra over rows appended to its assets (i.e. with append_df), 
+        portfolios, tracers and the current position in time are kept
+        """
+        self.hydra.extend()
+
     def reset(self, clear_history = True, clear_strategies = False):
         if clear_strategies:
             self.strategies = {}
@@ -105,7 +111,10 @@ class Hal:
                             asset_id : str,
                             exchange_id : str,
                             broker_id : str,
-                            warmup : int):
+                            warmup : int,
+                            column_major : bool = False,
+                            is_view : bool = False,
+                            column_types : dict = None):
         """register an load in a new asset from a pandas dataframe
 
         Args:
@@ -113,10 +122,72 @@ class Hal:
             asset_id (str): unique id of the new asset
             exchange_id (str): unique id of the exchange to place the asset on
             broker_id (str): unique id of the broker to place the asset on
+            column_major (bool): store the asset's data column-major
+            is_view (bool): load the asset as a zero-copy view of the dataframe's values
+            column_types (dict): storage type of columns (see asset_from_df)
         """
-        asset = asset_from_df(df, asset_id, exchange_id, broker_id, warmup)
+        asset = asset_from_df(df, asset_id, exchange_id, broker_id, warmup, column_major, is_view, column_types)
         self.register_asset(asset, exchange_id)
         
+    def register_asset_from_file(self,
+                            path : str,
+                            asset_id : str,
+                            exchange_id : str,
+                            broker_id : str,
+                            warmup : int = 0,
+                            prefetch : bool = False):
+        """register a new asset loaded natively from a file. .argus files are memory mapped,
+        .csv files are parsed without pandas and uncompressed .feather / .arrow files are read without
+        pyarrow (first column is the datetime index).
+
+        Args:
+            path (str): location of the asset file (see FastTest.write_asset_file)
+            asset_id (str): unique id of the new asset
+            exchange_id (str): unique id of the exchange to place the asset on
+            broker_id (str): unique id of the broker to place the asset on
+            prefetch (bool): start reading a .argus file into the page cache right away
+        """
+        if path.endswith(".argus"):
+            asset = FastTest.read_asset_file(path, asset_id, exchange_id, broker_id, warmup, prefetch)
+        else:
+            asset = FastTest.load_asset_file(path, asset_id, exchange_id, broker_id, warmup)
+        self.register_asset(asset, exchange_id)
+        
+    def register_assets_from_dir(self,
+                            dir_path : str,
+                            exchange_id : str,
+                            broker_id : str,
+                            warmup : int = 0,
+                            threads : int = 0):
+        """load every asset file in a directory on a pool of threads and register them on an exchange.
+        The asset id of each asset is its file name without the extension.
+
+        Args:
+            dir_path (str): directory holding the asset files
+            exchange_id (str): unique id of the exchange to place the assets on
+            broker_id (str): unique id of the broker to place the assets on
+            threads (int): number of worker threads, 0 uses one per hardware thread
+        """
+        exchange = self.hydra.get_exchange(exchange_id)
+        exchange.register_assets_from_dir(dir_path, broker_id, warmup, threads)
+
+    def register_lazy_assets_from_dir(self,
+                            dir_path : str,
+                            exchange_id : str,
+                            broker_id : str,
+                            warmup : int = 0):
+        """register every asset file in a directory as a lazy asset. Each asset's data is only loaded 
+        while it is streaming, so memory tracks the assets listed at the same time rather than the
+        whole universe. The files are read once when the hydra is built to get their datetime index.
+
+        Args:
+            dir_path (str): directory holding the asset files
+            exchange_id (str): unique id of the exchange to place the assets on
+            broker_id (str): unique id of the broker to place the assets on
+        """
+        exchange = self.hydra.get_exchange(exchange_id)
+        exchange.register_lazy_assets_from_dir(dir_path, broker_id, warmup)
+        
     def get_order_history(self):
         orders = self.hydra.get_order_history()
         orders_list = []
@@ -150,7 +221,10 @@ def asset_from_df(df: Type[pd.DataFrame],
                 asset_id: str,
                 exchange_id : str,
                 broker_id : str,
-                warmup = 0) -> Asset:
+                warmup = 0,
+                column_major : bool = False,
+                is_view : bool = False,
+                column_types : dict = None) -> Asset:
     """generate a new asset object from a pandas dataframe. Pandas index must have a datetime
     index. An easy conversion from datetime str as: df.set_index(pd.to_datetime(df.index).astype(np.int64), inplace=True)
 
@@ -159,16 +233,45 @@ def asset_from_df(df: Type[pd.DataFrame],
         asset_id (str): unique id of the new asset
         exchange_id (str): unique id of the exchange to place the asset on
         broker_id (str): unique id of the broker to place the asset on
+        column_major (bool): store the asset's data column-major so columns are contiguous
+        is_view (bool): don't copy the data, the asset keeps a reference to the underlying numpy 
+            arrays and views them directly (column-major for the usual fortran ordered df.values)
+        column_types (dict): map of column name to FastTest.AssetColumnType or a 
+            (FastTest.AssetColumnType.SCALED_INT32, scale) tuple. Columns not listed stay float64, 
+            open and close must stay float64. Can't be combined with is_view.
     Returns:
         Asset: a new Asset object
     """
     # extract underlying numpy arrays
-    values = df.values.astype(np.float64)
-    epoch_index = df.index.values.astype(np.int64)
+    if is_view:
+        # no-op for float64 frames, df.values is already fortran ordered
+        values = np.asfortranarray(df.values, dtype=np.float64)
+        epoch_index = np.ascontiguousarray(df.index.values, dtype=np.int64)
+    else:
+        values = df.values.astype(np.float64)
+        epoch_index = df.index.values.astype(np.int64)
 
     # load the asset
     asset = FastTest.new_asset(asset_id, exchange_id, broker_id, warmup)
     asset.load_headers(df.columns.tolist())
-    asset.load_data(values, epoch_index, df.shape[0], df.shape[1], False)
+    for column, column_type in (column_types or {}).items():
+        if isinstance(column_type, tuple):
+            asset.set_column_type(column, *column_type)
+        else:
+            asset.set_column_type(column, column_type)
+    asset.load_data(values, epoch_index, df.shape[0], df.shape[1], is_view, column_major)
 
-    return asset
\ No newline at end of file
+    return asset
+
+def append_df(asset: Asset, df: Type[pd.DataFrame]) -> None:
+    """append the rows of a pandas dataframe to a built asset. The dataframe must have the asset's
+    columns in the same order and an int64 ns epoch index after the asset's last row. Derived columns
+    added by the exchange can be left out, they are computed when the exchange is extended.
+
+    Args:
+        asset (Asset): built asset to append to
+        df (Type[pd.DataFrame]): new rows of the asset
+    """
+    values = np.asfortranarray(df.values, dtype=np.float64)
+    epoch_index = np.ascontiguousarray(df.index.values, dtype=np.int64)
+    asset.append_rows(values, epoch_index, df.shape[0])
@@ -44,6 +44,10 @@ broker_id = "broker1"
 broker = hal.new_broker(broker_id,100000.0)
 exchange = hal.new_exchange(exchange_id)
 
+# computed for every asset over its full history when the exchange is built,
+# the first 200 rows of each asset are warmup so the spread is defined once it streams
+exchange.add_derived_column("50MA_SPREAD", "Close - rolling_mean(Close, 50)")
+
 file_list = [os.path.join(dir_path, f) for f in os.listdir(dir_path) if os.path.isfile(os.path.join(dir_path, f))]
 candles = 0
 for _file in file_list:
@@ -54,11 +58,9 @@ for _file in file_list:
     df["Date"] = df["Date"] * 1e9
     df.set_index("Date", inplace=True)
     df.dropna(inplace = True)
-    df["50MA_SPREAD"] = (df["Close"] - df["Close"].rolling(50).mean())
-    df = df.iloc[200:]
     
-    hal.register_asset_from_df(df, asset_id, exchange_id, broker_id, warmup = 0) 
-    candles += len(df)
+    hal.register_asset_from_df(df, asset_id, exchange_id, broker_id, warmup = 200) 
+    candles += len(df) - 200
         
 strategy = TrendStrategy(hal)
 hal.register_strategy(strategy, "trend_strategy") 
@@ -29,12 +29,12 @@ def load_df(file_path, asset_id):
     return df
 
 
-def load_asset(file_path, asset_id, exchange_id, broker_id, is_view=False):
+def load_asset(file_path, asset_id, exchange_id, broker_id, is_view=False, column_major=False):
     df = pd.read_csv(file_path)
     df.set_index("DATE", inplace=True)
     df.set_index(pd.to_datetime(df.index).astype(np.int64), inplace=True)
 
-    asset = asset_from_df(df, asset_id, exchange_id, broker_id)
+    asset = asset_from_df(df, asset_id, exchange_id, broker_id, column_major=column_major)
 
     return asset
 
@@ -1,6 +1,8 @@
 
+import gc
 import sys
 import os
+import tempfile
 import unittest
 import numpy as np
 
@@ -36,6 +38,228 @@ class AssetTestMethods(unittest.TestCase):
         assert (asset1.get("CLOSE", 0) == 101)
         assert (asset1.get("OPEN", 3) == 105)
 
+    def test_asset_column_major(self):
+        asset1 = helpers.load_asset(
+            helpers.test1_file_path,
+            "asset1",
+            helpers.test1_exchange_id,
+            helpers.test1_broker_id,
+            column_major = True
+        )
+        assert (asset1.is_column_major)
+        assert (asset1.get("CLOSE", 0) == 101)
+        assert (asset1.get("OPEN", 3) == 105)
+
+    def test_asset_column_types(self):
+        df = helpers.load_df(helpers.test_spy_file_path, "asset1")
+        asset1 = asset_from_df(
+            df, "asset1", helpers.test1_exchange_id, helpers.test1_broker_id,
+            column_types = {
+                "HIGH" : FastTest.AssetColumnType.FLOAT32,
+                "LOW" : (FastTest.AssetColumnType.SCALED_INT32, 1 / 64)
+            }
+        )
+        assert (asset1.get_is_compact())
+        assert (asset1.get("CLOSE", 1) == df["CLOSE"].iloc[1])
+        assert (asset1.get("HIGH", 1) == np.float32(df["HIGH"].iloc[1]))
+        assert (asset1.get("LOW", 1) == df["LOW"].iloc[1])
+
+        with self.assertRaises(RuntimeError):
+            asset_from_df(
+                df, "asset1", helpers.test1_exchange_id, helpers.test1_broker_id,
+                column_types = {"CLOSE" : FastTest.AssetColumnType.FLOAT32}
+            )
+
+    def test_asset_shared_index(self):
+        asset1 = helpers.load_asset(
+            helpers.test1_file_path,
+            "asset1",
+            helpers.test1_exchange_id,
+            helpers.test1_broker_id
+        )
+        asset2 = helpers.load_asset(
+            helpers.test1_file_path,
+            "asset2",
+            helpers.test1_exchange_id,
+            helpers.test1_broker_id
+        )
+        index1 = asset1.get_datetime_index_view()
+        index2 = asset2.get_datetime_index_view()
+
+        # identical datetime indexes are interned and stored once
+        assert (index1.__array_interface__["data"][0] == index2.__array_interface__["data"][0])
+
+    def test_asset_view(self):
+        df = helpers.load_df(helpers.test1_file_path, "asset1")
+        df = df.astype(np.float64)
+        asset1 = asset_from_df(df, "asset1", helpers.test1_exchange_id, helpers.test1_broker_id, is_view = True)
+
+        # the asset holds a reference to the buffers, dropping the frame must not invalidate it
+        del df
+        gc.collect()
+
+        assert (asset1.is_column_major)
+        assert (asset1.get("CLOSE", 0) == 101)
+        assert (asset1.get("OPEN", 3) == 105)
+
+    def test_asset_file(self):
+        asset1 = helpers.load_asset(
+            helpers.test_spy_file_path,
+            "asset1",
+            helpers.test1_exchange_id,
+            helpers.test1_broker_id
+        )
+        with tempfile.TemporaryDirectory() as dir_path:
+            file_path = os.path.join(dir_path, "asset1.argus")
+            FastTest.write_asset_file(asset1, file_path)
+            asset2 = FastTest.read_asset_file(
+                file_path,
+                "asset1",
+                helpers.test1_exchange_id,
+                helpers.test1_broker_id
+            )
+            assert (asset2.is_column_major)
+            assert (np.array_equal(asset1.get_datetime_index_view(), asset2.get_datetime_index_view()))
+            assert (asset1.get("CLOSE", 100) == asset2.get("CLOSE", 100))
+            assert (asset1.get("HIGH", 5000) == asset2.get("HIGH", 5000))
+
+    def test_asset_stream(self):
+        asset1 = helpers.load_asset(
+            helpers.test_spy_file_path,
+            "asset1",
+            helpers.test1_exchange_id,
+            helpers.test1_broker_id
+        )
+        with tempfile.TemporaryDirectory() as dir_path:
+            file_path = os.path.join(dir_path, "asset1.argus")
+            FastTest.write_asset_file(asset1, file_path)
+            asset2 = FastTest.open_asset_stream(
+                file_path,
+                "asset1",
+                helpers.test1_exchange_id,
+                helpers.test1_broker_id,
+                chunk_rows = 1000,
+                lookback = 10
+            )
+            assert (asset2.get_is_stream())
+
+            hydra = FastTest.Hydra(0, 0.0)
+            hydra.new_broker(helpers.test1_broker_id, 100000.0)
+            exchange = hydra.new_exchange(helpers.test1_exchange_id)
+            exchange.register_asset(asset2)
+            hydra.build()
+
+            # step through several chunks and check the window follows the full asset
+            for i in range(2500):
+                hydra.forward_pass()
+                assert (asset2.get_asset_feature("CLOSE") == asset1.get("CLOSE", i))
+                if i >= 10:
+                    assert (asset2.get_asset_feature("OPEN", -10) == asset1.get("OPEN", i - 10))
+                hydra.backward_pass()
+
+            assert (asset2.get("HIGH", 2495) == asset1.get("HIGH", 2495))
+            with self.assertRaises(IndexError):
+                asset2.get("HIGH", 5000)
+
+    def test_asset_indicators(self):
+        asset1 = helpers.load_asset(
+            helpers.test_spy_file_path,
+            "asset1",
+            helpers.test1_exchange_id,
+            helpers.test1_broker_id
+        )
+        asset1.add_indicator("SMA_20", FastTest.IndicatorType.SMA, ["CLOSE"], 20)
+        asset1.add_indicator("MAX_5", FastTest.IndicatorType.MAXIMUM, ["HIGH"], 5)
+        with self.assertRaises(RuntimeError):
+            asset1.add_indicator("CLOSE", FastTest.IndicatorType.SMA, ["CLOSE"], 20)
+
+        hydra = FastTest.Hydra(0, 0.0)
+        hydra.new_broker(helpers.test1_broker_id, 100000.0)
+        exchange = hydra.new_exchange(helpers.test1_exchange_id)
+        exchange.register_asset(asset1)
+        hydra.build()
+
+        for i in range(100):
+            hydra.forward_pass()
+            sma = asset1.get_asset_feature("SMA_20")
+            if i < 19:
+                assert (np.isnan(sma))
+            else:
+                expected = np.mean([asset1.get("CLOSE", j) for j in range(i - 19, i + 1)])
+                assert (abs(sma - expected) < 1e-9)
+            expected_max = max(asset1.get("HIGH", j) for j in range(max(0, i - 4), i + 1))
+            assert (i < 4 or exchange.get_asset_feature("asset1", "MAX_5") == expected_max)
+            hydra.backward_pass()
+
+    def test_asset_resample(self):
+        df = helpers.load_df(helpers.test_spy_file_path, "asset1")
+        asset1 = asset_from_df(df, "asset1", helpers.test1_exchange_id, helpers.test1_broker_id)
+        week = 7 * 86400 * 10**9
+        weekly = asset1.resample(week, "asset1_weekly")
+
+        # compare against the same buckets grouped in pandas
+        groups = df.groupby(df.index.values // week)
+        expected = groups.agg({"OPEN": "first", "HIGH": "max", "LOW": "min", "CLOSE": "last"})
+        assert (np.array_equal(weekly.get_datetime_index_view(), groups.apply(lambda g: g.index[-1]).values))
+        for i in (0, 10, len(expected) - 1):
+            for column in ("OPEN", "HIGH", "LOW", "CLOSE"):
+                assert (weekly.get(column, i) == expected[column].iloc[i])
+
+    def test_asset_csv(self):
+        asset1 = helpers.load_asset(
+            helpers.test_spy_file_path,
+            "asset1",
+            helpers.test1_exchange_id,
+            helpers.test1_broker_id
+        )
+        asset2 = FastTest.read_csv_file(
+            helpers.test_spy_file_path,
+            "asset1",
+            helpers.test1_exchange_id,
+            helpers.test1_broker_id
+        )
+        assert (np.array_equal(asset1.get_datetime_index_view(), asset2.get_datetime_index_view()))
+        for column in ["OPEN", "HIGH", "LOW", "CLOSE"]:
+            assert (asset1.get(column, 0) == asset2.get(column, 0))
+            assert (asset1.get(column, 5000) == asset2.get(column, 5000))
+
+        # exports often quote every field, data rows included
+        with tempfile.TemporaryDirectory() as dir_path:
+            path = os.path.join(dir_path, "quoted.csv")
+            with open(path, "w") as file:
+                file.write('"Date","OPEN","CLOSE"\n')
+                file.write('"2000-06-05","101.5", "102"\n')
+                file.write('"2000-06-06","99",""\n')
+            asset3 = FastTest.read_csv_file(path, "asset3", helpers.test1_exchange_id, helpers.test1_broker_id)
+
+        expected_index = np.array(["2000-06-05", "2000-06-06"], dtype="datetime64[ns]").astype(np.int64)
+        assert (np.array_equal(asset3.get_datetime_index_view(), expected_index))
+        assert (asset3.get("OPEN", 0) == 101.5 and asset3.get("CLOSE", 0) == 102)
+        assert (asset3.get("OPEN", 1) == 99 and np.isnan(asset3.get("CLOSE", 1)))
+
+    def test_asset_feather(self):
+        try:
+            import pyarrow.feather as feather
+        except ImportError:
+            self.skipTest("pyarrow is not installed")
+
+        df = helpers.load_df(helpers.test1_file_path, helpers.test1_asset_id)
+        asset1 = asset_from_df(df, "asset1", helpers.test1_exchange_id, helpers.test1_broker_id)
+
+        with tempfile.TemporaryDirectory() as dir_path:
+            path = os.path.join(dir_path, "asset1.feather")
+            feather.write_feather(df.reset_index(), path, compression="uncompressed")
+            asset2 = FastTest.load_asset_file(
+                path,
+                "asset1",
+                helpers.test1_exchange_id,
+                helpers.test1_broker_id
+            )
+
+        assert (np.array_equal(asset1.get_datetime_index_view(), asset2.get_datetime_index_view()))
+        for column in df.columns:
+            assert (asset1.get(column, 0) == asset2.get(column, 0))
+
     def test_asset_memory_address(self):
         asset1 = helpers.load_asset(
             helpers.test1_file_path,
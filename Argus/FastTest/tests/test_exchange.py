@@ -1,15 +1,18 @@
 import gc
 import sys
 import os
+import tempfile
 import unittest
 from datetime import datetime
 
 import numpy as np
+import pandas as pd
 
 sys.path.append(os.path.abspath('..'))
 
 import FastTest
 from FastTest import ExchangeQueryType
+from Hal import asset_from_df, append_df
 import helpers
 
 class ExchangeTestMethods(unittest.TestCase):
@@ -52,6 +55,317 @@ class ExchangeTestMethods(unittest.TestCase):
 
         assert(np.array_equal(exchange_index, asset2.get_datetime_index_view()))
     
+    def test_exchange_union_datetime_index(self):
+        # staggered, overlapping indexes with different steps, more than one round of the k-way merge
+        hydra = FastTest.Hydra(0, 0.0)
+        exchange = hydra.new_exchange(helpers.test1_exchange_id)
+        indexes = []
+        for i in range(48):
+            index = (1000 * i + (i % 7 + 1) * np.arange(300)).astype(np.int64)
+            df = pd.DataFrame({"OPEN": np.ones(300), "CLOSE": np.ones(300)}, index=index)
+            exchange.register_asset(asset_from_df(df, f"asset{i}", helpers.test1_exchange_id, helpers.test1_broker_id))
+            indexes.append(index)
+        exchange.build()
+
+        expected = indexes[0]
+        for index in indexes[1:]:
+            expected = np.union1d(expected, index)
+        assert (np.array_equal(exchange.get_datetime_index_view(), expected))
+
+    def test_exchange_register_assets_from_dir(self):
+        with tempfile.TemporaryDirectory() as dir_path:
+            for file_path, asset_id in [(helpers.test1_file_path, helpers.test1_asset_id),
+                                        (helpers.test2_file_path, helpers.test2_asset_id)]:
+                asset = helpers.load_asset(file_path, asset_id, helpers.test1_exchange_id, helpers.test1_broker_id)
+                FastTest.write_asset_file(asset, os.path.join(dir_path, asset_id + ".argus"))
+
+            hydra = FastTest.Hydra(0, 0.0)
+            exchange = hydra.new_exchange(helpers.test1_exchange_id)
+            exchange.register_assets_from_dir(dir_path, helpers.test1_broker_id)
+            exchange.build()
+
+            asset2 = exchange.get_asset(helpers.test2_asset_id)
+            exchange_index = exchange.get_datetime_index_view()
+            assert(np.array_equal(exchange_index, asset2.get_datetime_index_view()))
+    
+    def test_exchange_lazy_asset(self):
+        asset2 = helpers.load_asset(
+            helpers.test2_file_path,
+            helpers.test2_asset_id,
+            helpers.test1_exchange_id,
+            helpers.test1_broker_id
+        )
+        loader = lambda: helpers.load_asset(
+            helpers.test1_file_path,
+            helpers.test1_asset_id,
+            helpers.test1_exchange_id,
+            helpers.test1_broker_id
+        )
+
+        hydra = FastTest.Hydra(0, 0.0)
+        hydra.new_broker(helpers.test1_broker_id, 100000.0)
+        exchange = hydra.new_exchange(helpers.test1_exchange_id)
+        exchange.register_asset(asset2)
+        exchange.register_lazy_asset(helpers.test1_asset_id, helpers.test1_broker_id, loader)
+        hydra.build()
+
+        # the lazy asset is only paged in once it starts streaming
+        asset1 = exchange.get_asset(helpers.test1_asset_id)
+        assert(not asset1.get_is_resident())
+        hydra.forward_pass()
+        assert(not asset1.get_is_resident())
+
+        hydra.backward_pass()
+        hydra.forward_pass()
+        assert(asset1.get_is_resident())
+        assert(exchange.get_asset_feature(helpers.test1_asset_id, "CLOSE") == 101)
+
+    def test_exchange_arena(self):
+        hydra = helpers.create_simple_hydra(logging=0)
+        hydra.build()
+
+        # test1 (4 rows) and test2 (6 rows) with 2 columns, each padded to a 64 byte block
+        exchange = hydra.get_exchange(helpers.test1_exchange_id)
+        assert(exchange.get_arena_size() == 64 + 128)
+        assert(hydra.get_arena_size() == exchange.get_arena_size())
+
+        hydra.forward_pass()
+        assert(exchange.get_asset_feature(helpers.test2_asset_id, "CLOSE") == 101.5)
+        hydra.backward_pass()
+
+        # the assets already live in the first arena, a rebuild has nothing to move
+        hydra.build()
+        assert(exchange.get_arena_size() == 0)
+        assert(hydra.get_arena_size() == 0)
+
+    def test_exchange_validation(self):
+        df = helpers.load_df(helpers.test2_file_path, helpers.test2_asset_id)
+        index = df.index.values.copy()
+        index[3] = index[2]
+        df.index = index
+        df.iloc[4, df.columns.get_loc("OPEN")] = np.nan
+        asset2 = asset_from_df(df, helpers.test2_asset_id, helpers.test1_exchange_id, helpers.test1_broker_id)
+
+        hydra = helpers.create_simple_hydra(logging=0)
+        exchange = hydra.get_exchange(helpers.test1_exchange_id)
+        exchange.build()
+        assert (exchange.get_validation_reports() == [])
+
+        hydra = FastTest.Hydra(0, 0.0)
+        exchange = hydra.new_exchange(helpers.test1_exchange_id)
+        exchange.register_asset(asset2)
+        exchange.build()
+
+        # bad rows are reported instead of failing the build
+        reports = exchange.get_validation_reports()
+        assert (len(reports) == 1)
+        report = reports[0]
+        assert (not report.is_valid())
+        assert (report.duplicates.count == 1 and report.duplicates.first_row == 3)
+        assert (report.invalid_open.count == 1 and report.invalid_open.first_row == 4)
+        assert (report.unsorted.passed() and report.invalid_close.passed())
+
+    def test_exchange_append_rows(self):
+        hydra = helpers.create_simple_hydra(logging=0)
+        exchange = hydra.get_exchange(helpers.test1_exchange_id)
+        asset1 = exchange.get_asset(helpers.test1_asset_id)
+        asset2 = exchange.get_asset(helpers.test2_asset_id)
+        hydra.build()
+
+        for _ in range(6):
+            hydra.forward_pass()
+            hydra.backward_pass()
+
+        # append a bar to both assets, asset1 expired before the end and starts streaming again
+        next_time = asset2.get_datetime_index_view()[-1] + 86400 * 10**9
+        for asset in (asset1, asset2):
+            asset.append_rows(np.array([110.0, 111.0]), np.array([next_time], dtype=np.int64), 1)
+        hydra.extend()
+
+        assert (exchange.get_datetime_index_view()[-1] == next_time)
+        assert (hydra.get_candles() == 12)
+
+        hydra.forward_pass()
+        assert (exchange.get_asset_feature(helpers.test1_asset_id, "OPEN") == 110)
+        assert (exchange.get_asset_feature(helpers.test2_asset_id, "CLOSE") == 111)
+        assert (exchange.get_asset_feature(helpers.test2_asset_id, "CLOSE", -1) == 96)
+
+    def test_exchange_asset_gap(self):
+        df = helpers.load_df(helpers.test1_file_path, helpers.test1_asset_id)
+        df = df.drop(df.index[1])
+        asset1 = asset_from_df(df, helpers.test1_asset_id, helpers.test1_exchange_id, helpers.test1_broker_id)
+        asset2 = helpers.load_asset(
+            helpers.test2_file_path,
+            helpers.test2_asset_id,
+            helpers.test1_exchange_id,
+            helpers.test1_broker_id
+        )
+
+        hydra = FastTest.Hydra(0, 0.0)
+        hydra.new_broker(helpers.test1_broker_id, 100000.0)
+        exchange = hydra.new_exchange(helpers.test1_exchange_id)
+        exchange.register_asset(asset1)
+        exchange.register_asset(asset2)
+        hydra.build()
+
+        # asset1 pauses on the day it has no row and streams again on its next row, before and after a reset
+        expected = [None, 101.0, None, 105.0, 106.0, None]
+        for _ in range(2):
+            for close in expected:
+                hydra.forward_pass()
+                exchange_features = exchange.get_exchange_feature("CLOSE")
+                assert (exchange_features.get(helpers.test1_asset_id) == close)
+                assert (helpers.test2_asset_id in exchange_features)
+                hydra.backward_pass()
+            hydra.reset(True, False)
+
+    def test_exchange_late_listing(self):
+        index = np.arange(10, dtype=np.int64)
+        df1 = pd.DataFrame({"OPEN": np.arange(10.0), "CLOSE": np.arange(10.0)}, index=index)
+        df2 = pd.DataFrame({"OPEN": 100 + np.arange(6.0), "CLOSE": 100 + np.arange(6.0)}, index=index[4:])
+        asset1 = asset_from_df(df1, helpers.test1_asset_id, helpers.test1_exchange_id, helpers.test1_broker_id)
+        asset2 = asset_from_df(df2, helpers.test2_asset_id, helpers.test1_exchange_id, helpers.test1_broker_id)
+
+        hydra = FastTest.Hydra(0, 0.0)
+        hydra.new_broker(helpers.test1_broker_id, 100000.0)
+        exchange = hydra.new_exchange(helpers.test1_exchange_id)
+        exchange.register_asset(asset1)
+        exchange.register_asset(asset2)
+        hydra.build()
+
+        # asset2's index is a slice of the exchange's, it is aligned but only streams from its offset
+        assert (asset2.is_alligned and asset2.exchange_offset == 4)
+
+        for _ in range(2):
+            for i in range(10):
+                hydra.forward_pass()
+                exchange_features = exchange.get_exchange_feature("CLOSE")
+                assert (exchange_features[helpers.test1_asset_id] == i)
+                if i < 4:
+                    assert (helpers.test2_asset_id not in exchange_features)
+                else:
+                    assert (exchange_features[helpers.test2_asset_id] == 100 + i - 4)
+                hydra.backward_pass()
+            hydra.reset(True, False)
+
+    def test_exchange_regular_index(self):
+        # three sessions of 60 one minute bars with overnight gaps
+        minute = 60 * 10**9
+        sessions = [pd.Timestamp("2000-06-05 09:30") + pd.Timedelta(days=d) for d in range(3)]
+        index = np.concatenate([s.value + minute * np.arange(60) for s in sessions]).astype(np.int64)
+        df = pd.DataFrame({"OPEN": np.arange(180.0), "CLOSE": np.arange(180.0)}, index=index)
+        asset1 = asset_from_df(df, helpers.test1_asset_id, helpers.test1_exchange_id, helpers.test1_broker_id)
+
+        # gapless minute asset listed from the 11th bar of the second session
+        asset2 = asset_from_df(df.iloc[70:90], helpers.test2_asset_id, helpers.test1_exchange_id, helpers.test1_broker_id)
+
+        hydra = FastTest.Hydra(0, 0.0)
+        hydra.new_broker(helpers.test1_broker_id, 100000.0)
+        exchange = hydra.new_exchange(helpers.test1_exchange_id)
+        exchange.register_asset(asset1)
+        exchange.register_asset(asset2)
+        hydra.build()
+
+        assert (exchange.get_is_index_regular())
+        assert (asset2.is_alligned and asset2.exchange_offset == 70)
+
+        # regular asset indexes are derived from their runs
+        assert (np.array_equal(asset2.get_datetime_index_view(), index[70:90]))
+
+        # before the first bar, between two steps, inside the overnight gap and on a bar
+        for target in (index[0] - 5 * minute, index[5] + minute // 2, index[59] + 120 * minute, index[130]):
+            hydra.goto_datetime(int(target))
+            hydra.forward_pass()
+            position = np.searchsorted(index, target)
+            assert (hydra.get_hydra_time() == index[position])
+            assert (exchange.get_asset_feature(helpers.test1_asset_id, "CLOSE") == position)
+            hydra.backward_pass()
+
+        with self.assertRaises(RuntimeError):
+            hydra.goto_datetime(int(index[-1] + minute))
+
+    def test_exchange_derived_column(self):
+        hydra = helpers.create_simple_hydra(logging=0)
+        exchange = hydra.get_exchange(helpers.test1_exchange_id)
+        exchange.add_derived_column("SPREAD", "CLOSE - OPEN")
+        exchange.add_derived_column("SPREAD_MA", "rolling_mean(SPREAD, 2)")
+        with self.assertRaises(RuntimeError):
+            exchange.add_derived_column("BAD", "rolling_mean(CLOSE)")
+        for window in ("inf", "1e30", "nan"):
+            with self.assertRaises(RuntimeError):
+                exchange.add_derived_column("BAD", f"lag(CLOSE, {window})")
+        hydra.build()
+
+        hydra.forward_pass()
+        assert (exchange.get_asset_feature(helpers.test2_asset_id, "SPREAD") == 0.5)
+        assert (np.isnan(exchange.get_asset_feature(helpers.test2_asset_id, "SPREAD_MA")))
+
+        hydra.backward_pass()
+        hydra.forward_pass()
+        assert (exchange.get_asset_feature(helpers.test2_asset_id, "SPREAD") == -1)
+        assert (exchange.get_asset_feature(helpers.test2_asset_id, "SPREAD_MA") == -0.25)
+
+    def test_exchange_derived_column_collision(self):
+        # a derived column can't replace one of the asset's own columns
+        hydra = helpers.create_simple_hydra(logging=0)
+        exchange = hydra.get_exchange(helpers.test1_exchange_id)
+        exchange.add_derived_column("CLOSE", "OPEN * 2")
+        with self.assertRaises(RuntimeError):
+            hydra.build()
+
+    def test_exchange_derived_column_append(self):
+        hydra = helpers.create_simple_hydra(logging=0)
+        exchange = hydra.get_exchange(helpers.test1_exchange_id)
+        asset2 = exchange.get_asset(helpers.test2_asset_id)
+        exchange.add_derived_column("SPREAD", "CLOSE - OPEN")
+        exchange.add_derived_column("SPREAD_MA", "rolling_mean(SPREAD, 2)")
+        hydra.build()
+
+        for _ in range(6):
+            hydra.forward_pass()
+            hydra.backward_pass()
+
+        # only the source columns are appended, the derived ones are computed when the exchange is extended
+        next_time = asset2.get_datetime_index_view()[-1] + 86400 * 10**9
+        df = pd.DataFrame({"OPEN": [110.0], "CLOSE": [111.0]}, index=np.array([next_time], dtype=np.int64))
+        append_df(asset2, df)
+        hydra.extend()
+
+        hydra.forward_pass()
+        assert (exchange.get_asset_feature(helpers.test2_asset_id, "SPREAD") == 1)
+        assert (exchange.get_asset_feature(helpers.test2_asset_id, "SPREAD_MA") == -3)
+        assert (exchange.get_asset_feature(helpers.test2_asset_id, "SPREAD", -1) == -7)
+
+    def test_exchange_feature_cache(self):
+        with tempfile.TemporaryDirectory() as dir_path:
+            values = []
+            for _ in range(2):
+                hydra = helpers.create_simple_hydra(logging=0)
+                exchange = hydra.get_exchange(helpers.test1_exchange_id)
+                exchange.add_derived_column("SPREAD", "CLOSE - OPEN")
+                exchange.set_feature_cache(dir_path)
+                hydra.build()
+                hydra.forward_pass()
+                values.append(exchange.get_asset_feature(helpers.test2_asset_id, "SPREAD"))
+
+            # the second build reads both assets' columns from the cache
+            cache = exchange.get_feature_cache()
+            assert (cache.get_hits() == 2 and cache.get_misses() == 0)
+            assert (values[0] == values[1] == 0.5)
+
+    def test_exchange_schema(self):
+        hydra = helpers.create_simple_hydra(logging=0)
+        exchange = hydra.get_exchange(helpers.test1_exchange_id)
+        asset2 = exchange.get_asset(helpers.test2_asset_id)
+        hydra.build()
+        hydra.forward_pass()
+
+        # both assets have the same columns so column ids are valid for the whole exchange
+        schema = exchange.get_schema()
+        assert (schema is not None and schema.get_columns() == ["OPEN", "CLOSE"])
+        close_id = asset2.get_column_index("CLOSE")
+        assert (asset2.get_asset_feature(close_id) == asset2.get_asset_feature("CLOSE") == 101.5)
+
     def test_exchange_get_asset_feature(self):
         hydra = helpers.create_simple_hydra(logging=0)
         
@@ -63,12 +377,23 @@ class ExchangeTestMethods(unittest.TestCase):
         assert(exchange.get_asset_feature(helpers.test2_asset_id, "CLOSE",0) == 101.5)
         assert(exchange.get_asset_feature(helpers.test2_asset_id, "CLOSE") == 101.5)
         
+        # lookbacks before the first row raise instead of wrapping around
+        with self.assertRaises(IndexError):
+            exchange.get_asset_feature(helpers.test2_asset_id, "CLOSE", -1)
+        
         hydra.backward_pass()
         hydra.forward_pass()
         
         assert(exchange.get_asset_feature(helpers.test2_asset_id, "CLOSE") == 99)
         assert(exchange.get_asset_feature(helpers.test2_asset_id, "OPEN") == 100)
         assert(exchange.get_asset_feature(helpers.test2_asset_id, "OPEN", -1) == 101)
+
+        # asset1 streams its last row on 2000-06-09 and is expired on the next bar
+        for _ in range(4):
+            hydra.backward_pass()
+            hydra.forward_pass()
+        with self.assertRaises(IndexError):
+            exchange.get_asset_feature(helpers.test1_asset_id, "CLOSE")
         
     def test_exchange_get_exchange_feature(self):
         hydra = helpers.create_simple_hydra(logging=0)
@@ -275,6 +275,29 @@ class HalTestMethods(unittest.TestCase):
         nlv_history = mp.get_tracer(PortfolioTracerType.VALUE).get_nlv_history()
         assert(np.array_equal(np.array([99900, 100350, 100350, 99800]),nlv_history))
         
+    def test_hal_goto_backward(self):
+        hal = helpers.create_simple_hal(logging=0)
+        hydra = hal.get_hydra()
+        exchange = hal.get_exchange(helpers.test1_exchange_id)
+
+        hal.build()
+        hal.goto_datetime("2000-06-12")
+        hydra.forward_pass()
+
+        # asset1 has no rows left on the last day
+        exchange_features = exchange.get_exchange_feature("CLOSE")
+        assert(exchange_features[helpers.test2_asset_id] == 96)
+        assert(helpers.test1_asset_id not in exchange_features)
+        hydra.backward_pass()
+
+        # going back in time brings asset1 back into the market
+        hal.goto_datetime("2000-06-08")
+        hydra.forward_pass()
+        exchange_features = exchange.get_exchange_feature("CLOSE")
+        assert(exchange_features[helpers.test2_asset_id] == 101.5)
+        assert(exchange_features[helpers.test1_asset_id] == 105)
+        assert(exchange.get_asset_feature(helpers.test1_asset_id, "CLOSE", -1) == 103)
+
     def test_hal_goto_multi(self):
         hal = helpers.create_simple_hal(logging=0)
         hydra = hal.get_hydra()
@@ -0,0 +1,58 @@
+#ifndef ARGUS_ARENA_H
+#define ARGUS_ARENA_H
+
+#include <cstddef>
+
+using namespace std;
+
+/// alignment of every block handed out by an arena (one cache line, enough for any simd load)
+static constexpr size_t ARENA_ALIGNMENT = 64;
+
+/// round a size in bytes up to the arena alignment
+inline size_t arena_align(size_t bytes)
+{
+    return (bytes + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+}
+
+/**
+ * @brief fixed capacity bump allocator over a single anonymous mapping. Blocks are never freed
+ *        individually, the whole region is released at once when the arena is destroyed.
+ */
+class Arena
+{
+public:
+    /**
+     * @brief map a new arena
+     *
+     * @param capacity size of the arena in bytes
+     * @param huge_pages ask the kernel to back the arena with transparent huge pages
+     */
+    explicit Arena(size_t capacity, bool huge_pages = false);
+
+    /// unmap the arena
+    ~Arena();
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    /// allocate an ARENA_ALIGNMENT aligned block of bytes, throws if the arena is full
+    void *allocate(size_t bytes);
+
+    /// number of bytes handed out so far (including alignment padding)
+    [[nodiscard]] size_t get_size() const { return this->size; }
+
+    /// total size of the arena in bytes
+    [[nodiscard]] size_t get_capacity() const { return this->capacity; }
+
+private:
+    /// start of the mapping
+    char *data = nullptr;
+
+    /// size of the mapping in bytes
+    size_t capacity = 0;
+
+    /// offset of the next free byte
+    size_t size = 0;
+};
+
+#endif // ARGUS_ARENA_H
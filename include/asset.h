@@ -5,6 +5,8 @@
 #ifndef ARGUS_ASSET_H
 #define ARGUS_ASSET_H
 #include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <string>
 #include <memory>
 #include <utility>
@@ -14,20 +16,66 @@
 #include <pybind11/stl.h>
 #include <pybind11/numpy.h>
 
+#include "asset_validation.h"
+#include "datetime_index.h"
+#include "indicator.h"
+#include "schema.h"
 #include "utils_array.h"
 
 namespace py = pybind11;
 using namespace std;
 
 class Asset;
+class AssetStream;
 class AssetTracer;
 
+/// storage type of an asset column, narrow types are widened to double when read
+enum AssetColumnType
+{
+    Float64,    // full precision double
+    Float32,    // single precision float
+    ScaledInt32 // int32 multiplied by the column's scale, INT32_MIN is stored for NaN
+};
+
+/// storage of a single column of an asset using per-column storage types
+struct AssetColumn
+{
+    /// type the column's values are stored as
+    AssetColumnType type = Float64;
+
+    /// multiplier applied to ScaledInt32 values
+    double scale = 1;
+
+    /// start of the column's contiguous values
+    const void *data = nullptr;
+
+    /// read the value at a row of the column as a double
+    [[nodiscard]] inline double get(size_t row_index) const
+    {
+        switch (this->type)
+        {
+        case Float32:
+            return static_cast<const float *>(this->data)[row_index];
+        case ScaledInt32:
+        {
+            auto value = static_cast<const int32_t *>(this->data)[row_index];
+            return value == INT32_MIN ? NAN : value * this->scale;
+        }
+        default:
+            return static_cast<const double *>(this->data)[row_index];
+        }
+    }
+};
+
 
 class Asset
 {
 public:
     typedef shared_ptr<Asset> asset_sp_t;
 
+    /// function loading the data of a lazy asset, returns a new built asset with the same id
+    typedef std::function<asset_sp_t()> asset_loader_t;
+
     /// asset constructor
     Asset(string asset_id, string exchange_id, string broker_id, size_t warmup = 0);
 
@@ -42,10 +90,24 @@ public:
      */
     asset_sp_t fork_view();
 
+    /**
+     * @brief build a view of the asset aggregated to a coarser interval. Bars are bucketed by
+     *        floor(datetime / interval) (i.e. daily buckets start at midnight utc) and each bucket
+     *        is stamped with the datetime of its last row so the bar is only seen once it is complete.
+     *        Open takes the first value of a bucket, high the max, low the min, volume the sum and 
+     *        every other column the last value, nan values are skipped. The aggregates are computed 
+     *        in a single pass into a buffer shared with any forks of the view.
+     * 
+     * @param interval length of a bucket in ns
+     * @param asset_id_ unique id of the resampled asset
+     * @return asset_sp_t new built asset with one row per non-empty bucket
+     */
+    asset_sp_t resample(long long interval, const string &asset_id_);
+
     /// reset asset to start of data
     void reset_asset();
 
-    /// move the asset to an exact point in time
+    /// move the asset to it's first row at or after a point in time, forward or backward
     void goto_datetime(long long datetime);
 
     /// unique id of the asset
@@ -57,8 +119,17 @@ public:
     /// unique id of the broker the asset is listed on 
     string broker_id;
 
-    /// is the asset's datetime index alligend with it's exchange
-    bool is_alligned;
+    /// are the asset's streamed rows a contiguous slice of it's exchange's datetime index
+    bool is_alligned = false;
+
+    /// position in the exchange's datetime index of the asset's first streamed row if it is alligned
+    size_t exchange_offset = 0;
+
+    /// dense id of the asset on it's exchange, the asset's slot in the exchange's market view
+    size_t market_id = 0;
+
+    /// is the asset's data stored column-major (each column is a contiguous slice)
+    bool is_column_major = false;
 
     /// warmup period, i.e. number of rows to skip
     size_t warmup = 0;
@@ -84,8 +155,29 @@ public:
     /// return the id of an asset
     [[nodiscard]] string get_asset_id() const;
 
-    /// return pointer to the first element of the datetime index;
-    [[nodiscard]] long long *get_datetime_index(bool warmup_start = false) const;
+    /// return pointer to the first element of the datetime index, a regular index is expanded on the first call
+    [[nodiscard]] long long const *get_datetime_index(bool warmup_start = false) const;
+
+    /// time stamp of a row of the asset, regular indexes derive it from their runs
+    [[nodiscard]] long long get_datetime(size_t row) const
+    {
+        return this->datetime_index ? this->datetime_index[row] : this->datetime_index_sp->at(row);
+    }
+
+    /// copy rows [first, first + count) of the datetime index to out without expanding a regular index
+    void copy_datetime_index(size_t first, size_t count, long long *out) const;
+
+    /// interned datetime index the asset reads, nullptr if the index is a view of memory it doesn't own
+    [[nodiscard]] const DatetimeIndex *get_interned_datetime_index() const
+    {
+        // regular indexes are read through their runs, the asset holds no pointer into them
+        auto index = this->datetime_index_sp.get();
+        if (!index || (index->is_regular() ? this->datetime_index != nullptr : index->get_data() != this->datetime_index))
+        {
+            return nullptr;
+        }
+        return index;
+    }
 
     /// test if the function is built
     [[nodiscard]] bool get_is_built() const;
@@ -93,17 +185,183 @@ public:
     /// load in the headers of an asset from python list
     void load_headers(const vector<string> &headers);
 
-    /// load the asset data in from a pointer, copy to dynamically allocated double**
-    void load_data(const double *data, const long long *datetime_index, size_t rows, size_t cols);
-    void load_view(double *data, long long *datetime_index, size_t rows, size_t cols);
+    /// get the column names of the asset ordered by column index
+    [[nodiscard]] vector<string> get_column_names() const;
+
+    /// does the asset have a column with the given name
+    [[nodiscard]] bool has_column(const string &column) const { return this->schema && this->schema->has_column(column); }
+
+    /// does the asset have an online indicator with the given name
+    [[nodiscard]] bool has_indicator(const string &name) const { return this->indicator_headers.count(name) > 0; }
+
+    /// index of a column, throws a key error if the asset does not have it
+    [[nodiscard]] size_t get_column_index(const string &column) const;
+
+    /// interned schema of the asset's columns, shared by every asset with identical columns
+    [[nodiscard]] schema_sp_t get_schema() const { return this->schema; }
+
+    /**
+     * @brief add new columns to a built asset, the asset keeps its layout and position in time. Views
+     *        are copied into memory owned by the asset, streaming and lazy assets can't have columns added.
+     * 
+     * @param names names of the new columns
+     * @param values column formated 1d array of the new columns, rows values each
+     * @param derived are the columns computed by the exchange from derived column expressions
+     */
+    void add_columns(const vector<string> &names, const double *values, bool derived = false);
+
+    /// copy a full column of the asset into a contiguous buffer of length rows
+    void copy_column(size_t column_index, double *out) const;
+
+    /// read a value by column index, row_index must be in memory
+    [[nodiscard]] double read_value(size_t column_index, size_t row_index) const;
+
+    /// overwrite count rows of a float64 column starting at first_row
+    void write_column(size_t column_index, size_t first_row, const double *values, size_t count);
+
+    /// number of trailing columns computed from derived column expressions
+    [[nodiscard]] size_t get_derived_cols() const { return this->derived_cols; }
+
+    /**
+     * @brief set the type a column is stored as, must be called after the headers are loaded and 
+     *        before the data is. Assets with any non float64 column store each column contiguously in
+     *        its own type and widen values to double on read. The open and close columns used to fill
+     *        orders always keep full precision.
+     * 
+     * @param column name of the column
+     * @param type storage type of the column
+     * @param scale multiplier of ScaledInt32 columns, i.e. 0.01 stores prices to the cent
+     */
+    void set_column_type(const string &column, AssetColumnType type, double scale = 1);
+
+    /// does the asset store any column in a type other than float64
+    [[nodiscard]] bool get_is_compact() const { return this->is_compact; }
+
+    /**
+     * @brief make the asset lazy, its data is only resident while it is streaming. The loader is 
+     *        called once when the exchange is built to get the asset's datetime index and then every 
+     *        time the asset is paged back in. The datetime index stays resident.
+     * 
+     * @param loader function returning a new built asset holding the data
+     */
+    void set_loader(asset_loader_t loader);
+
+    /// is the asset's data loaded on demand
+    [[nodiscard]] bool get_is_lazy() const { return static_cast<bool>(this->loader); }
+
+    /// is the asset's data currently in memory
+    [[nodiscard]] bool get_is_resident() const { return this->is_resident; }
+
+    /// load the data of a lazy asset using its loader, the asset keeps its position in time
+    void page_in();
+
+    /// release the data of a lazy asset, its headers and datetime index are kept
+    void page_out();
+
+    /// bytes of data the asset owns and could move into an arena, 0 if the asset is a view or compact
+    [[nodiscard]] size_t get_owned_data_size() const;
+
+    /**
+     * @brief move the data the asset owns into memory owned by someone else (i.e. an exchange's arena),
+     *        the layout and position in time are kept and the old buffer is freed
+     * 
+     * @param destination block of at least get_owned_data_size() bytes
+     * @param owner handle keeping the destination alive for the lifetime of the asset
+     */
+    void move_data(double *destination, shared_ptr<void> owner);
+
+    /**
+     * @brief check the asset's datetime index is strictly increasing and its open and close prices are 
+     *        finite and positive. Prices are only checked if the data is in memory. The report is kept
+     *        and returned by get_validation_report.
+     * 
+     * @return AssetValidationReport counts and first rows of each failed check
+     */
+    AssetValidationReport validate();
+
+    /// report of the last validation of the asset, assets are validated when loaded or built
+    [[nodiscard]] const AssetValidationReport &get_validation_report() const { return this->validation_report; }
+
+    /**
+     * @brief stream the asset's data from a chunked reader instead of holding all of it in memory,
+     *        the headers must already be loaded. Only the stream's lookback rows before the current
+     *        one can be read.
+     * 
+     * @param stream reader holding the window of rows around the current one
+     */
+    void load_stream(shared_ptr<AssetStream> stream);
+
+    /// is the asset's data streamed in chunks
+    [[nodiscard]] bool get_is_stream() const { return static_cast<bool>(this->stream); }
 
-    /// load the asset data using a python buffer
+    /**
+     * @brief load the asset data in from a column formated pointer, copy to dynamically allocated double*.
+     *        The datetime index is interned, assets with identical indexes share a single copy.
+     * 
+     * @param data column formated 1d array ([col1_0, col1_1, col2_0, col2_1])
+     * @param datetime_index ns epoch datetime index of the data
+     * @param rows number of rows in the data
+     * @param cols number of columns in the data
+     * @param column_major store the data column-major instead of transposing it to row-major
+     */
+    void load_data(
+        const double *data, 
+        const long long *datetime_index, 
+        size_t rows, 
+        size_t cols, 
+        bool column_major = false);
+
+    /**
+     * @brief point the asset at existing data, the data is expected to already be in the given layout
+     * 
+     * @param data_owner optional handle keeping the viewed memory alive for the lifetime of the asset
+     */
+    void load_view(
+        double *data, 
+        long long const *datetime_index, 
+        size_t rows, 
+        size_t cols, 
+        bool column_major = false,
+        shared_ptr<void> data_owner = nullptr);
+
+    /// point the asset at existing data with an interned datetime index, see load_view above
+    void load_view(
+        double *data, 
+        datetime_index_sp_t datetime_index, 
+        size_t rows, 
+        size_t cols, 
+        bool column_major,
+        shared_ptr<void> data_owner);
+
+    /**
+     * @brief append new rows to the end of a built asset, the asset keeps its position in time. The data
+     *        buffer grows geometrically so repeated appends only copy the new rows on average. Views
+     *        are copied into memory owned by the asset on their first append, lazy and streaming 
+     *        assets can't be appended to.
+     * 
+     * @param data column formated 1d array of the new rows ([col1_0, col1_1, col2_0, col2_1])
+     * @param datetime_index ns epoch datetime index of the new rows, must be after the asset's last row
+     * @param rows number of new rows
+     */
+    void append_rows(const double *data, const long long *datetime_index, size_t rows);
+
+    /// append new rows to the asset from python buffers, see append_rows. The data can leave out the
+    /// derived columns, they are nan until the exchange computes them when it is extended
+    void py_append_rows(const py::buffer &data, const py::buffer &datetime_index, size_t rows);
+
+    /**
+     * @brief load the asset data using a python buffer. If is_view is set the asset points directly
+     *        at the buffer's memory and holds a reference to the python objects so they outlive the asset.
+     *        2d buffers loaded as views use their own memory layout, i.e. a fortran ordered df.values 
+     *        is loaded column-major without any copy or transpose.
+     */
     void py_load_data(
         const py::buffer &data, 
         const py::buffer &datetime_index, 
         size_t rows, 
         size_t cols,
-        bool is_view);
+        bool is_view,
+        bool column_major = false);
 
     /// get data point from current asset row
     [[nodiscard]] double c_get(size_t column_offset) const;
@@ -115,7 +373,7 @@ public:
     [[nodiscard]] double get_market_price(bool on_close) const;
 
     /// get the current datetime of the asset
-    [[nodiscard]] long long *get_asset_time() const;
+    [[nodiscard]] long long const *get_asset_time() const;
 
     /// get read only numpy array of the asset's datetime index
     py::array_t<long long> get_datetime_index_view();
@@ -129,6 +387,16 @@ public:
      */
     [[nodiscard]] double get_asset_feature(const string& column_name, int index = 0);
 
+    /**
+     * @brief Get specific data point from asset object by column index, skips the name lookup. The
+     *        index of a column is valid for every asset on the same schema
+     * 
+     * @param column_index index of the column in the asset's schema
+     * @param index row index to look at, 0 is current, -1 is previous, ...
+     * @return double value at that location
+     */
+    [[nodiscard]] double get_asset_feature(size_t column_index, int index = 0);
+
     /**
      * @brief Get a column from the asset, end index is the current value
      * 
@@ -141,6 +409,18 @@ public:
     /// step the asset forward in time
     void step();
 
+    /**
+     * @brief attach an indicator updated every time the asset steps, its current value is read with
+     *        get_asset_feature(name). Rows the asset skipped over (warmup, goto_datetime) are added
+     *        on the next step.
+     * 
+     * @param name name to read the indicator by, can't be the name of a column
+     * @param type what the indicator computes
+     * @param columns columns the indicator reads, high, low and close for an atr
+     * @param window number of rows in the indicator's window (span of an ema)
+     */
+    void add_indicator(const string &name, IndicatorType type, const vector<string> &columns, size_t window);
+
 private:
     /// has the asset been built
     bool is_built = false;
@@ -148,11 +428,72 @@ private:
     /// does the asset own the underlying data pointer
     bool is_view = false;
 
-    /// map between column name and column index
-    tsl::robin_map<string, size_t> headers;
+    /// keeps the data alive, the asset's own buffer or the memory a view points to (i.e. python buffers),
+    /// shared with any forks so they outlive a reallocation of the asset's data
+    shared_ptr<void> data_owner;
+
+    /// is the asset's data in memory, false for lazy assets that are paged out
+    bool is_resident = false;
+
+    /// loader of a lazy asset, empty if the asset's data is always resident
+    asset_loader_t loader;
+
+    /// point the asset at the data of another built asset
+    void load_view_of(const Asset &source, shared_ptr<void> data_owner);
+
+    /// report of the last validation of the asset
+    AssetValidationReport validation_report;
+
+    /// chunked reader of a streaming asset, null if the asset's data is fully loaded
+    shared_ptr<AssetStream> stream;
+
+    /// index at which the stream's window has to advance before the asset can step
+    size_t stream_limit = SIZE_MAX;
+
+    /// load the stream's window so it holds the given row and point the asset at it
+    void seek_stream(size_t row_index);
+
+    /// slide the stream's window forward and re-base the row pointer on it
+    void advance_stream();
+
+    /// does the asset use per-column storage types, if so data and row are unused
+    bool is_compact = false;
+
+    /// per-column storage types, empty unless set_column_type has been called
+    vector<AssetColumn> column_storage;
+
+    /// number of trailing columns computed from derived column expressions, filled in when rows are appended
+    size_t derived_cols = 0;
+
+    /// does any column have a storage type other than float64
+    [[nodiscard]] bool has_compact_columns() const;
 
-    /// datetime index of the asset (ns epoch time stamp)
-    long long *datetime_index;
+    /// copy column formated data into per-column storage of each column's type
+    void load_compact_data(const double *data, size_t rows, size_t cols);
+
+    /// interned column names of the asset, shared with forks and assets with identical columns
+    schema_sp_t schema;
+
+    /// online indicators attached to the asset
+    vector<AssetIndicator> indicators;
+
+    /// map between indicator name and index in indicators
+    tsl::robin_map<string, size_t> indicator_headers;
+
+    /// number of rows added to the indicators, caught up to current_index on step
+    size_t indicator_rows = 0;
+
+    /// add the rows the asset stepped over to its indicators
+    void update_indicators();
+
+    /// datetime index of the asset (ns epoch time stamp), null if it is a regular interned index
+    long long const *datetime_index = nullptr;
+
+    /// interned datetime index the asset points to, null if the index is a view
+    datetime_index_sp_t datetime_index_sp;
+
+    /// read the datetime index from an interned index, a regular index is not expanded
+    void set_interned_datetime_index(datetime_index_sp_t index);
 
     /// underlying data of the asset
     double * data;
@@ -166,6 +507,21 @@ private:
     /// number of columns in the asset data
     size_t cols;
 
+    /// number of rows the asset's data buffer has room for, greater than rows after appending
+    size_t capacity = 0;
+
+    /// move the asset's data into a new buffer owned by the asset with room for the given number of rows
+    void grow(size_t new_capacity);
+
+    /// distance between two consecutive rows of the same column (cols if row-major, 1 if column-major)
+    size_t row_stride = 0;
+
+    /// distance between two consecutive columns of the same row (1 if row-major, rows if column-major)
+    size_t column_stride = 0;
+
+    /// set the row and column strides given the layout of the data (both 0 for compact assets)
+    void set_layout(bool column_major);
+
     /// index of the current row the asset is at
     size_t current_index;
 
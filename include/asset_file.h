@@ -0,0 +1,168 @@
+#ifndef ARGUS_ASSET_FILE_H
+#define ARGUS_ASSET_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <memory>
+#include <vector>
+
+#include "asset.h"
+
+using namespace std;
+
+/// magic bytes at the start of every .argus file
+static constexpr char ARGUS_FILE_MAGIC[8] = {'A', 'R', 'G', 'U', 'S', 'F', 'T', '\0'};
+
+/// version of the .argus file format written by this build
+static constexpr uint32_t ARGUS_FILE_VERSION = 1;
+
+/// alignment of the datetime index and data blocks inside of a .argus file
+static constexpr size_t ARGUS_FILE_ALIGNMENT = 64;
+
+/**
+ * @brief fixed size header at the start of a .argus file. The file layout is
+ *
+ *        [header][schema][pad][datetime index][pad][column 0][column 1]...[column n]
+ *
+ *        the schema is a list of (uint32 length, bytes) column names, the datetime index is
+ *        rows int64 ns epoch timestamps and the data block is the asset's data stored column-major
+ *        (rows doubles per column). The index and data blocks are 64 byte aligned.
+ */
+struct ArgusFileHeader
+{
+    /// ARGUS_FILE_MAGIC
+    char magic[8];
+
+    /// file format version
+    uint32_t version;
+
+    /// reserved for future use
+    uint32_t flags;
+
+    /// number of rows in the asset
+    uint64_t rows;
+
+    /// number of columns in the asset
+    uint64_t cols;
+
+    /// byte offset and size of the column names
+    uint64_t schema_offset;
+    uint64_t schema_size;
+
+    /// byte offset of the datetime index block
+    uint64_t index_offset;
+
+    /// byte offset of the column-major data block
+    uint64_t data_offset;
+
+    /// total size of the file in bytes
+    uint64_t file_size;
+};
+
+/**
+ * @brief read only memory mapping of a file, unmapped on destruction
+ */
+class MappedFile
+{
+public:
+    /// map an existing file into memory
+    explicit MappedFile(const string &path);
+
+    /// unmap the file
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /// pointer to the start of the mapping
+    [[nodiscard]] const char *get_data() const { return this->data; }
+
+    /// size of the mapping in bytes
+    [[nodiscard]] size_t get_size() const { return this->size; }
+
+    /**
+     * @brief hint to the kernel how a region of the mapping will be accessed
+     *
+     * @param offset byte offset of the region
+     * @param length length of the region in bytes
+     * @param advice posix madvise flag (i.e. MADV_WILLNEED, MADV_SEQUENTIAL)
+     */
+    void advise(size_t offset, size_t length, int advice) const;
+
+private:
+    /// path of the mapped file
+    string path;
+
+    /// start of the mapping
+    const char *data = nullptr;
+
+    /// size of the mapping
+    size_t size = 0;
+};
+
+/**
+ * @brief write a built asset to a .argus file
+ *
+ * @param asset asset to write
+ * @param path location of the file to write
+ */
+void write_asset_file(const shared_ptr<Asset> &asset, const string &path);
+
+/**
+ * @brief validate the header of a mapped .argus file and parse its column names
+ *
+ * @param file mapping of the whole file
+ * @param path location of the file, used in error messages
+ * @param column_names filled with the names of the file's columns
+ * @return ArgusFileHeader the file's header
+ */
+ArgusFileHeader read_asset_file_header(const MappedFile &file, const string &path, vector<string> &column_names);
+
+/**
+ * @brief create a new asset backed directly by a memory mapped .argus file, no data is copied
+ *        and the pages can be shared between every process that maps the same file
+ *
+ * @param path location of the .argus file
+ * @param asset_id unique id of the new asset
+ * @param exchange_id unique id of the exchange the asset is on
+ * @param broker_id unique id of the broker the asset is listed on
+ * @param warmup number of rows to skip
+ * @param prefetch ask the kernel to start reading the whole data block into the page cache
+ * @return shared_ptr<Asset> new asset viewing the mapped file
+ */
+shared_ptr<Asset> read_asset_file(
+    const string &path,
+    const string &asset_id,
+    const string &exchange_id,
+    const string &broker_id,
+    size_t warmup = 0,
+    bool prefetch = false);
+
+/// can the file at path be loaded by load_asset_file (dispatched on the file extension)
+bool is_asset_file(const string &path);
+
+/// get the sorted paths of all loadable asset files in a directory
+vector<string> list_asset_files(const string &dir_path);
+
+/// asset id of an asset file, the file name without its extension
+string asset_id_from_path(const string &path);
+
+/**
+ * @brief load a new asset from a file, the reader is picked based on the file extension
+ *
+ * @param path location of the asset file
+ * @param asset_id unique id of the new asset
+ * @param exchange_id unique id of the exchange the asset is on
+ * @param broker_id unique id of the broker the asset is listed on
+ * @param warmup number of rows to skip
+ * @return shared_ptr<Asset> new asset loaded from the file
+ */
+shared_ptr<Asset> load_asset_file(
+    const string &path,
+    const string &asset_id,
+    const string &exchange_id,
+    const string &broker_id,
+    size_t warmup = 0);
+
+#endif // ARGUS_ASSET_FILE_H
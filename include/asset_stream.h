@@ -0,0 +1,144 @@
+#ifndef ARGUS_ASSET_STREAM_H
+#define ARGUS_ASSET_STREAM_H
+
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "asset.h"
+#include "asset_file.h"
+
+using namespace std;
+
+/**
+ * @brief sliding window over the data block of a .argus file that is too large to hold in memory.
+ *        The window holds the last lookback rows plus one chunk, stored column-major. Chunks are read
+ *        sequentially with pread and the next chunk is read on a background thread while the current
+ *        one is being stepped through. The datetime index stays memory mapped.
+ */
+class AssetStream
+{
+public:
+    /**
+     * @brief open a .argus file for streaming
+     *
+     * @param path location of the .argus file
+     * @param chunk_rows number of rows read at a time
+     * @param lookback number of rows before the current one that stay in the window
+     */
+    AssetStream(const string &path, size_t chunk_rows, size_t lookback);
+
+    /// wait for any pending read and close the file
+    ~AssetStream();
+
+    AssetStream(const AssetStream &) = delete;
+    AssetStream &operator=(const AssetStream &) = delete;
+
+    /// column names of the file
+    [[nodiscard]] const vector<string> &get_column_names() const { return this->column_names; }
+
+    /// number of rows in the file
+    [[nodiscard]] size_t get_rows() const { return this->header.rows; }
+
+    /// number of columns in the file
+    [[nodiscard]] size_t get_cols() const { return this->header.cols; }
+
+    /// number of rows kept before the current one
+    [[nodiscard]] size_t get_lookback() const { return this->lookback; }
+
+    /// pointer to the mapped datetime index of the file
+    [[nodiscard]] long long const *get_datetime_index() const;
+
+    /// first row of the file held in the window
+    [[nodiscard]] size_t get_window_start() const { return this->window_start; }
+
+    /// one past the last row of the file held in the window
+    [[nodiscard]] size_t get_window_end() const { return this->window_start + this->window_rows; }
+
+    /// number of rows the window can hold, the distance between two columns of the window
+    [[nodiscard]] size_t get_window_capacity() const { return this->lookback + this->chunk_rows; }
+
+    /// start of the column-major window
+    [[nodiscard]] double *get_window() { return this->window.data(); }
+
+    /// load the window so it holds the given row and up to lookback rows before it
+    void seek(size_t row_index);
+
+    /// slide the window forward by one chunk, keeping the last lookback rows
+    void advance();
+
+private:
+    /// mapping of the file, only the header, schema and index are read through it
+    shared_ptr<MappedFile> file;
+
+    /// descriptor the data block is read through
+    int fd = -1;
+
+    /// header of the file
+    ArgusFileHeader header{};
+
+    /// column names of the file
+    vector<string> column_names;
+
+    /// number of rows read at a time
+    size_t chunk_rows;
+
+    /// number of rows before the current one kept in the window
+    size_t lookback;
+
+    /// column-major window of lookback + chunk_rows rows
+    vector<double> window;
+
+    /// first row of the file held in the window
+    size_t window_start = 0;
+
+    /// number of rows held in the window
+    size_t window_rows = 0;
+
+    /// column-major buffer the next chunk is read into
+    vector<double> chunk;
+
+    /// first row of the chunk being read into the buffer
+    size_t chunk_start = 0;
+
+    /// number of rows being read into the buffer
+    size_t chunk_count = 0;
+
+    /// background read of the next chunk
+    future<void> pending;
+
+    /// read rows of every column into a column-major buffer with the given distance between columns
+    void read(size_t start, size_t count, double *out, size_t column_stride) const;
+
+    /// start reading the chunk starting at the given row on a background thread
+    void prefetch(size_t start);
+
+    /// wait for the background read if there is one
+    void wait();
+};
+
+/**
+ * @brief create a new asset that streams its data from a .argus file instead of loading it. Only
+ *        lookback rows before the current one can be read with get_asset_feature and get_column.
+ *
+ * @param path location of the .argus file
+ * @param asset_id unique id of the new asset
+ * @param exchange_id unique id of the exchange the asset is on
+ * @param broker_id unique id of the broker the asset is listed on
+ * @param warmup number of rows to skip
+ * @param chunk_rows number of rows read at a time
+ * @param lookback number of rows before the current one that stay in memory
+ * @return shared_ptr<Asset> new streaming asset
+ */
+shared_ptr<Asset> open_asset_stream(
+    const string &path,
+    const string &asset_id,
+    const string &exchange_id,
+    const string &broker_id,
+    size_t warmup = 0,
+    size_t chunk_rows = 65536,
+    size_t lookback = 256);
+
+#endif // ARGUS_ASSET_STREAM_H
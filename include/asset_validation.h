@@ -0,0 +1,92 @@
+#ifndef ARGUS_ASSET_VALIDATION_H
+#define ARGUS_ASSET_VALIDATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+/// row value of a validation check that found no bad rows
+static constexpr size_t VALIDATION_NO_ROW = SIZE_MAX;
+
+/**
+ * @brief count and first location of the rows failing a single validation check
+ */
+struct ValidationCheck
+{
+    /// number of rows failing the check
+    size_t count = 0;
+
+    /// index of the first row failing the check, VALIDATION_NO_ROW if none do
+    size_t first_row = VALIDATION_NO_ROW;
+
+    /// did every row pass the check
+    [[nodiscard]] bool passed() const { return this->count == 0; }
+};
+
+/**
+ * @brief result of validating an asset's data. Problems are collected instead of thrown so every
+ *        asset of a load can be checked and reported on at once.
+ */
+struct AssetValidationReport
+{
+    /// unique id of the asset validated
+    string asset_id;
+
+    /// number of rows validated
+    size_t rows = 0;
+
+    /// has the asset been validated
+    bool is_checked = false;
+
+    /// were the open and close prices validated, false if the data was not in memory
+    bool prices_checked = false;
+
+    /// rows with a timestamp before the previous row's
+    ValidationCheck unsorted;
+
+    /// rows with the same timestamp as the previous row
+    ValidationCheck duplicates;
+
+    /// rows with a nan, inf or non-positive open price
+    ValidationCheck invalid_open;
+
+    /// rows with a nan, inf or non-positive close price
+    ValidationCheck invalid_close;
+
+    /// did the asset pass every check
+    [[nodiscard]] bool is_valid() const;
+
+    /// human readable summary of the failed checks
+    [[nodiscard]] string to_string() const;
+
+    /**
+     * @brief add the report of rows appended to the validated rows
+     *
+     * @param appended report of the appended rows only
+     * @param row_offset number of rows validated before the appended ones
+     */
+    void merge(const AssetValidationReport &appended, size_t row_offset);
+};
+
+/**
+ * @brief check a datetime index is strictly increasing
+ *
+ * @param datetime_index ns epoch datetime index
+ * @param rows number of rows in the index
+ * @param report report to fill the unsorted and duplicate checks of
+ */
+void validate_datetime_index(long long const *datetime_index, size_t rows, AssetValidationReport &report);
+
+/**
+ * @brief check a column of prices is finite and positive
+ *
+ * @param values pointer to the first value of the column
+ * @param rows number of values in the column
+ * @param stride distance between two consecutive values (1 if the column is contiguous)
+ * @param check check to fill
+ */
+void validate_prices(const double *values, size_t rows, size_t stride, ValidationCheck &check);
+
+#endif // ARGUS_ASSET_VALIDATION_H
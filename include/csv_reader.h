@@ -0,0 +1,63 @@
+#ifndef ARGUS_CSV_READER_H
+#define ARGUS_CSV_READER_H
+
+#include <cstddef>
+#include <string>
+#include <memory>
+
+#include "asset.h"
+
+using namespace std;
+
+/**
+ * @brief parse a floating point number from a character range, leading and trailing spaces are
+ *        ignored and an empty field parses to NaN
+ *
+ * @param begin start of the field
+ * @param end one past the end of the field
+ * @param value parsed value
+ * @return bool was the whole field a valid number
+ */
+bool parse_double(const char *begin, const char *end, double &value);
+
+/**
+ * @brief parse a datetime from a character range into a ns epoch timestamp. Accepts ISO-8601
+ *        dates and datetimes (YYYY-MM-DD[( |T)HH:MM[:SS[.fffffffff]]][Z|(+|-)HH:MM], naive values
+ *        are treated as UTC) and integer epoch timestamps
+ *
+ * @param begin start of the field
+ * @param end one past the end of the field
+ * @param epoch_scale multiplier applied to integer epoch timestamps to convert them to ns
+ * @param value parsed ns epoch timestamp
+ * @return bool was the whole field a valid datetime
+ */
+bool parse_datetime(const char *begin, const char *end, long long epoch_scale, long long &value);
+
+/**
+ * @brief load a new asset directly from a csv file without going through pandas. The file is memory
+ *        mapped and parsed straight into the asset's column-major buffers, the open and close columns
+ *        are found by the asset's headers (case insensitive)
+ *
+ * @param path location of the csv file
+ * @param asset_id unique id of the new asset
+ * @param exchange_id unique id of the exchange the asset is on
+ * @param broker_id unique id of the broker the asset is listed on
+ * @param warmup number of rows to skip
+ * @param datetime_column name of the datetime column (case insensitive), empty uses the first column
+ * @param epoch_unit unit of integer epoch datetimes, one of s, ms, us, ns
+ * @param delimiter field delimiter
+ * @param threads number of threads used to parse the file, 0 means one per hardware thread
+ * @return shared_ptr<Asset> new asset holding the file's data
+ */
+shared_ptr<Asset> read_csv_file(
+    const string &path,
+    const string &asset_id,
+    const string &exchange_id,
+    const string &broker_id,
+    size_t warmup = 0,
+    const string &datetime_column = "",
+    const string &epoch_unit = "ns",
+    char delimiter = ',',
+    size_t threads = 1);
+
+#endif // ARGUS_CSV_READER_H
@@ -0,0 +1,128 @@
+#ifndef ARGUS_DATETIME_INDEX_H
+#define ARGUS_DATETIME_INDEX_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+/// minimum average run length for an index to be treated as regular, below it lookups fall back to binary search
+static constexpr size_t REGULAR_INDEX_MIN_RUN_LENGTH = 16;
+
+/// stretch of a regular datetime index where consecutive time stamps are one step apart
+struct IndexRun
+{
+    /// time stamp of the first row of the run
+    long long start;
+
+    /// position of the first row of the run in the index
+    size_t first_row;
+};
+
+/**
+ * @brief immutable ns epoch datetime index. Indexes are interned, every asset, exchange and hydra
+ *        with identical datetime indexes shares a single reference counted copy. Regular indexes
+ *        are stored as their step and runs only, their rows are derived on demand and the full
+ *        array is only expanded for consumers that ask for a pointer to it.
+ */
+class DatetimeIndex
+{
+public:
+    /// create a new datetime index from its values, use intern_datetime_index to share it
+    explicit DatetimeIndex(vector<long long> values);
+
+    DatetimeIndex(const DatetimeIndex &) = delete;
+    DatetimeIndex &operator=(const DatetimeIndex &) = delete;
+
+    /// pointer to the first element of the index, a regular index is expanded on the first call and
+    /// keeps the expanded array for as long as it is alive
+    [[nodiscard]] long long const *get_data() const;
+
+    /// number of elements in the index
+    [[nodiscard]] size_t get_size() const { return this->size; }
+
+    /// time stamp of a row, regular indexes derive it from the row's run
+    [[nodiscard]] long long at(size_t row) const;
+
+    /// copy rows [first, first + count) of the index to out without expanding a regular index
+    void copy_values(size_t first, size_t count, long long *out) const;
+
+    /// are rows [first, first + count) of the index equal to values
+    [[nodiscard]] bool matches(size_t first, long long const *values, size_t count) const;
+
+    /// hash of the index's values
+    [[nodiscard]] size_t get_hash() const { return this->hash; }
+
+    /// is the index made of a few runs of a fixed step, i.e. fixed interval bars with session gaps
+    [[nodiscard]] bool is_regular() const { return !this->runs.empty(); }
+
+    /// step between consecutive rows of a run if the index is regular
+    [[nodiscard]] long long get_step() const { return this->step; }
+
+    /// runs of the index if it is regular
+    [[nodiscard]] const vector<IndexRun> &get_runs() const { return this->runs; }
+
+    /**
+     * @brief position of the first time stamp at or after a datetime, the same as std::lower_bound.
+     *        Regular indexes find the run by binary search over the runs and the row within it
+     *        arithmetically, O(1) for an index without gaps.
+     *
+     * @param datetime ns epoch datetime to search for
+     * @param first position to start searching from
+     * @return size_t position of the time stamp, the size of the index if there is none
+     */
+    [[nodiscard]] size_t lower_bound(long long datetime, size_t first = 0) const;
+
+    /// are rows [first, first + count) in a single run, i.e. one step apart without a gap
+    [[nodiscard]] bool is_contiguous(size_t first, size_t count) const;
+
+private:
+    /// number of elements in the index
+    size_t size = 0;
+
+    /// ns epoch time stamps of the index, empty for a regular index until it is expanded
+    mutable vector<long long> values;
+
+    /// guards the expansion of a regular index, get_data can be called from multiple threads
+    mutable once_flag expand_flag;
+
+    /// step between consecutive rows of a run, 0 if the index is not regular
+    long long step = 0;
+
+    /// runs of the index ordered by time, empty if the index is not regular
+    vector<IndexRun> runs;
+
+    /// find the step and runs of the index if it is regular
+    void detect_runs();
+
+    /// run containing a row of a regular index
+    [[nodiscard]] vector<IndexRun>::const_iterator find_run(size_t row) const;
+
+    /// hash of the values, used to look up the index in the pool
+    size_t hash;
+};
+
+typedef shared_ptr<const DatetimeIndex> datetime_index_sp_t;
+
+/// hash a datetime index
+size_t hash_datetime_index(long long const *values, size_t length);
+
+/**
+ * @brief get the shared copy of a datetime index, the values are copied into the pool if no
+ *        identical index is alive. Two interned indexes are equal if and only if their data pointers are.
+ *
+ * @param values pointer to the first element of the index
+ * @param length number of elements in the index
+ * @return datetime_index_sp_t shared datetime index, it is released from the pool once the last reference is dropped
+ */
+datetime_index_sp_t intern_datetime_index(long long const *values, size_t length);
+
+/// get the shared copy of a datetime index, the values are moved into the pool if no identical index is alive
+datetime_index_sp_t intern_datetime_index(vector<long long> &&values);
+
+/// number of distinct datetime indexes alive in the pool
+size_t get_interned_datetime_index_count();
+
+#endif // ARGUS_DATETIME_INDEX_H
@@ -4,6 +4,8 @@
 
 #ifndef ARGUS_EXCHANGE_H
 #define ARGUS_EXCHANGE_H
+#include <climits>
+#include <cstdint>
 #include <string>
 #include <memory>
 #include <utility>
@@ -11,7 +13,10 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/numpy.h>
 
+#include "arena.h"
 #include "asset.h"
+#include "datetime_index.h"
+#include "expression.h"
 #include "order.h"
 
 #include "pybind11/pytypes.h"
@@ -28,6 +33,22 @@ enum ExchangeQueryType
     NExtreme
 };
 
+/// active slot of an asset that is not streaming
+static constexpr size_t NO_ACTIVE_SLOT = SIZE_MAX;
+
+/// asset starting or stopping streaming at a position of an exchange's datetime index
+struct ActivationEvent
+{
+    /// position in the exchange's datetime index the event happens at
+    size_t position;
+
+    /// asset the event is for
+    Asset *asset;
+
+    /// does the asset start streaming (true) or pause until a later row (false)
+    bool is_activation;
+};
+
 class Exchange
 {
 public:
@@ -59,6 +80,17 @@ public:
     /// build the exchange
     void build();
 
+    /**
+     * @brief extend a built exchange after rows were appended to its assets. Only the new timestamps are
+     *        merged into the datetime index, the exchange and its assets keep their position in time and 
+     *        expired assets with new rows start streaming again. New timestamps must be after the last 
+     *        one the exchange (or the hydra driving it) has streamed.
+     * 
+     * @param streamed_until last time streamed by the hydra driving the exchange
+     * @return vector<long long> timestamps added to the exchange's datetime index
+     */
+    vector<long long> extend(long long streamed_until = LLONG_MIN);
+
     /// reset the exchange to the start of the simulation
     void reset_exchange();
 
@@ -68,11 +100,92 @@ public:
     /// register an asset on the exchange
     void register_asset(const asset_sp_t &asset);
 
+    /**
+     * @brief load asset files on a pool of worker threads and register them on the exchange, the
+     *        asset id of each asset is its file name without the extension
+     * 
+     * @param paths locations of the asset files to load
+     * @param broker_id unique id of the broker the assets are listed on
+     * @param warmup number of rows to skip for each asset
+     * @param threads number of worker threads, 0 means one per hardware thread
+     */
+    void register_assets_from_files(
+        const vector<string> &paths, 
+        const string &broker_id, 
+        size_t warmup = 0, 
+        size_t threads = 0);
+
+    /// load every asset file in a directory in parallel and register them on the exchange
+    void register_assets_from_dir(
+        const string &dir_path, 
+        const string &broker_id, 
+        size_t warmup = 0, 
+        size_t threads = 0);
+
+    /**
+     * @brief register an asset whose data is only resident while it is streaming. It is paged in 
+     *        right before it first enters the market view and paged out once it expires, so memory
+     *        tracks the number of assets listed at the same time instead of the whole universe.
+     * 
+     * @param asset_id unique id of the asset
+     * @param broker_id unique id of the broker the asset is listed on
+     * @param loader function returning a new built asset holding the asset's data
+     */
+    void register_lazy_asset(const string &asset_id, const string &broker_id, Asset::asset_loader_t loader);
+
+    /// register lazy assets loaded from asset files, the asset id of each asset is its file name
+    void register_lazy_assets_from_files(
+        const vector<string> &paths, 
+        const string &broker_id, 
+        size_t warmup = 0);
+
+    /// register every asset file in a directory as a lazy asset
+    void register_lazy_assets_from_dir(
+        const string &dir_path, 
+        const string &broker_id, 
+        size_t warmup = 0);
+
     /// move all assets that have expired out of the market
     void move_expired_assets();
 
+    /// bytes of arena memory needed to hold the data owned by the exchange's assets
+    [[nodiscard]] size_t get_arena_request() const;
+
+    /// move the data owned by the exchange's assets into the arena, contiguous in market order
+    void move_assets_to_arena(const shared_ptr<Arena> &arena);
+
+    /// bytes of asset data the exchange moved into the arena on its last build
+    [[nodiscard]] size_t get_arena_size() const { return this->arena_size; }
+
     optional<vector<asset_sp_t>*> get_expired_assets();
 
+    /**
+     * @brief register a column computed for every asset when the exchange is built, i.e.
+     *        add_derived_column("SPREAD", "CLOSE - rolling_mean(CLOSE, 50)"). The expression is
+     *        compiled immediately so syntax errors are raised here instead of at build.
+     * 
+     * @param name name of the new column
+     * @param expression expression over the asset's columns and earlier derived columns
+     */
+    void add_derived_column(const string &name, const string &expression);
+
+    /**
+     * @brief store derived columns in a directory and reuse them on later builds, entries are keyed
+     *        by the expression and the asset data it reads so changed data is recomputed
+     * 
+     * @param dir_path directory of the cache, created if it does not exist
+     */
+    void set_feature_cache(const string &dir_path);
+
+    /// cache of derived columns, null if not set
+    [[nodiscard]] shared_ptr<FeatureCache> get_feature_cache() const { return this->feature_cache; }
+
+    /// schema shared by every asset on the exchange, null if the assets have different columns
+    [[nodiscard]] schema_sp_t get_schema() const { return this->schema; }
+
+    /// validation reports of the assets that failed validation when the exchange was built
+    [[nodiscard]] const vector<AssetValidationReport> &get_validation_reports() const { return this->validation_reports; }
+
     /// process open orders on the exchange
     void process_orders();
 
@@ -94,7 +207,10 @@ public:
     /// get read only pointer to datetime index
     long long const * get_datetime_index() { return this->datetime_index; }
 
-    /// move exchange to specific point in time
+    /// is the exchange's datetime index made of fixed step runs, seeks into it are arithmetic
+    [[nodiscard]] bool get_is_index_regular() const { return this->datetime_index_sp && this->datetime_index_sp->is_regular(); }
+
+    /// move exchange and it's assets to the first bar at or after a point in time, forward or backward
     void goto_datetime(long long datetime);
 
     /// get read exchange current time
@@ -117,10 +233,18 @@ public:
         int N = -1
     );
 
+    /// get the dense id of a listed asset, throws std::out_of_range if the asset is not listed
+    inline size_t get_market_id(const string &asset_id) const { return this->market_ids.at(asset_id); }
+
     inline double get_market_price(const string &asset_id)
+    {
+        return this->get_market_price(this->get_market_id(asset_id));
+    }
+
+    inline double get_market_price(size_t market_id)
     {
         // get pointer to asset, nullptr if asset is not currently streaming
-        auto asset_raw_pointer = this->market_view.at(asset_id);
+        auto asset_raw_pointer = this->market_view[market_id];
         if (asset_raw_pointer)
         {
             return asset_raw_pointer->get_market_price(this->on_close);
@@ -140,12 +264,42 @@ private:
     /// unique id of the exchange
     string exchange_id;
 
-    /// mapping for asset's available at the current moment;
-    tsl::robin_map<string, Asset *> market_view;
+    /// asset's available at the current moment indexed by market id, nullptr if not streaming
+    vector<Asset *> market_view;
+
+    /// dense id of every asset ever listed on the exchange, only used to resolve ids at the api boundary
+    tsl::robin_map<string, size_t> market_ids;
+
+    /// give a newly listed asset the next market id and a slot in the market view
+    void add_market_id(Asset *asset);
+
+    /// market id of an order's asset, resolved on the order's first visit to the exchange
+    size_t resolve_market_id(Order &order);
 
     /// container for storing asset_id's that have finished streaming
     vector<asset_sp_t> expired_assets;
 
+    /// changes to the set of streaming assets ordered by position, built with the datetime index
+    vector<ActivationEvent> activation_schedule;
+
+    /// index of the next event of the activation schedule
+    size_t schedule_index = 0;
+
+    /// assets stepped on every bar until they pause or expire
+    vector<Asset *> active_assets;
+
+    /// position of each asset in active_assets indexed by market id, NO_ACTIVE_SLOT if it isn't active
+    vector<size_t> active_slots;
+
+    /// do the active assets have to be rebuilt from the schedule before the next bar
+    bool is_schedule_stale = true;
+
+    /// build the activation schedule from the rows of every asset in the market
+    void build_activation_schedule();
+
+    /// rebuild the active assets and market view from the schedule up to the current index
+    void replay_activation_schedule();
+
     /// open orders on the exchange
     vector<shared_ptr<Order>> open_orders;
 
@@ -153,7 +307,10 @@ private:
     long long exchange_time;
 
     /// exchange datetime index
-    long long *datetime_index;
+    long long const *datetime_index = nullptr;
+
+    /// interned exchange datetime index, shared with any asset or exchange with the same index
+    datetime_index_sp_t datetime_index_sp;
 
     /// length of datetime index
     size_t datetime_index_length;
@@ -161,6 +318,33 @@ private:
     /// current position in datetime index
     size_t current_index;
 
+    /// bytes of asset data moved into the arena on the last build
+    size_t arena_size = 0;
+
+    /// validation reports of the assets that failed validation
+    vector<AssetValidationReport> validation_reports;
+
+    /// columns computed for every asset at build, in registration order
+    vector<DerivedColumn> derived_columns;
+
+    /// cache of derived columns, null if not set
+    shared_ptr<FeatureCache> feature_cache;
+
+    /// schema shared by every asset on the exchange, null if the assets have different columns
+    schema_sp_t schema;
+
+    /// number of rows of each asset included in the datetime index
+    tsl::robin_map<string, size_t> indexed_rows;
+
+    /// test if each asset is alligned with a slice of the datetime index
+    void allign_assets();
+
+    /// alligned assets that start with the exchange are in the market view before the first bar
+    static bool starts_in_view(const Asset *asset)
+    {
+        return asset->is_alligned && !asset->exchange_offset && !asset->get_is_lazy();
+    }
+
     /// process open orders on the exchange
     void process_order(shared_ptr<Order> &open_order);
 
@@ -0,0 +1,148 @@
+#ifndef ARGUS_EXPRESSION_H
+#define ARGUS_EXPRESSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "asset.h"
+#include "feature_cache.h"
+
+using namespace std;
+
+/// largest number of rows of a lag, rolling or ewm window
+static constexpr size_t EXPRESSION_MAX_WINDOW = UINT32_MAX;
+
+/// operation of a compiled expression, every operation produces a whole column
+enum ExpressionOpCode
+{
+    LoadColumn,  // copy of an asset column
+    Add,         // lhs + rhs
+    Subtract,    // lhs - rhs
+    Multiply,    // lhs * rhs
+    Divide,      // lhs / rhs
+    Negate,      // -lhs
+    Lag,         // lhs shifted forward by window rows
+    RollingMean, // mean of the last window rows of lhs
+    RollingStd,  // sample standard deviation of the last window rows of lhs
+    RollingMin,  // minimum of the last window rows of lhs
+    RollingMax,  // maximum of the last window rows of lhs
+    Ewm          // exponentially weighted mean of lhs with a span of window rows
+};
+
+/// input of an expression operation, either a constant or the column produced by an earlier operation
+struct ExpressionOperand
+{
+    /// is the operand a constant
+    bool is_constant = false;
+
+    /// value of a constant operand
+    double constant = 0;
+
+    /// index of the operation producing the operand
+    size_t op_index = 0;
+};
+
+/// single operation of a compiled expression
+struct ExpressionOp
+{
+    /// what the operation computes
+    ExpressionOpCode code;
+
+    /// first input of the operation
+    ExpressionOperand lhs;
+
+    /// second input of binary operations
+    ExpressionOperand rhs;
+
+    /// number of rows of lag, rolling and ewm operations
+    size_t window = 0;
+
+    /// name of the column read by LoadColumn
+    string column;
+};
+
+/**
+ * @brief expression over the columns of an asset compiled to a flat list of column-wide operations.
+ *        Supports + - * /, unary minus, parentheses, numbers, column names (quoted with backticks if
+ *        they are not identifiers, i.e. `50MA`) and the functions lag(x, n), rolling_mean(x, n),
+ *        rolling_std(x, n), rolling_min(x, n), rolling_max(x, n) and ewm(x, span). Rows without a
+ *        full window are nan, as are rolling results over windows containing a nan.
+ */
+class Expression
+{
+public:
+    /// compile an expression, throws std::runtime_error on a syntax error
+    explicit Expression(string source);
+
+    /// source the expression was compiled from
+    [[nodiscard]] const string &get_source() const { return this->source; }
+
+    /// names of the columns the expression reads
+    [[nodiscard]] const vector<string> &get_columns() const { return this->columns; }
+
+    /// compiled operations in evaluation order
+    [[nodiscard]] const vector<ExpressionOp> &get_ops() const { return this->ops; }
+
+    /// number of earlier rows a row's value can depend on, SIZE_MAX if it depends on every earlier row (ewm)
+    [[nodiscard]] size_t get_lookback() const;
+
+    /**
+     * @brief evaluate the expression over a set of columns
+     *
+     * @param column function returning a pointer to the rows values of a column by name
+     * @param rows number of rows in every column
+     * @param out buffer of rows values to write the result to
+     */
+    void evaluate(const std::function<const double *(const string &)> &column, size_t rows, double *out) const;
+
+private:
+    /// source the expression was compiled from
+    string source;
+
+    /// compiled operations in evaluation order
+    vector<ExpressionOp> ops;
+
+    /// result of the expression, a constant or the column of the last operation
+    ExpressionOperand result;
+
+    /// names of the columns the expression reads
+    vector<string> columns;
+
+    friend class ExpressionParser;
+};
+
+/// column computed from an expression over the other columns of every asset on an exchange
+struct DerivedColumn
+{
+    /// name of the new column
+    string name;
+
+    /// expression computing the column
+    Expression expression;
+};
+
+/**
+ * @brief evaluate derived columns over an asset and add them to the asset's columns. Derived columns
+ *        are evaluated in order and can read the derived columns before them.
+ *
+ * @param asset built asset to add the columns to
+ * @param derived_columns columns to add, columns added by an earlier call are skipped and a name
+ *        equal to one of the asset's own columns throws std::runtime_error
+ * @param cache optional cache to read computed columns from and store them to
+ */
+void add_derived_columns(Asset &asset, const vector<DerivedColumn> &derived_columns, FeatureCache *cache = nullptr);
+
+/**
+ * @brief compute the derived columns of rows appended to an asset. Each column is evaluated over the
+ *        new rows and the lookback window before them, rows before first_row are left as they are.
+ *
+ * @param asset asset the derived columns were added to
+ * @param derived_columns columns to compute, in the order they were added
+ * @param first_row first appended row
+ */
+void update_derived_columns(Asset &asset, const vector<DerivedColumn> &derived_columns, size_t first_row);
+
+#endif // ARGUS_EXPRESSION_H
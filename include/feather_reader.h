@@ -0,0 +1,39 @@
+#ifndef ARGUS_FEATHER_READER_H
+#define ARGUS_FEATHER_READER_H
+
+#include <cstddef>
+#include <string>
+#include <memory>
+
+#include "asset.h"
+
+using namespace std;
+
+/**
+ * @brief load a new asset from an uncompressed Feather v2 / Arrow IPC file without any arrow
+ *        dependency. The file is memory mapped, numeric and bool columns are loaded into the asset's
+ *        column-major storage and the datetime column into the datetime index. If the file holds a
+ *        single record batch of float64 columns without nulls that are laid out back to back, the asset
+ *        views the mapping directly, as does the datetime index if it is already int64 ns timestamps.
+ *        String and dictionary encoded columns are skipped.
+ *
+ * @param path location of the feather file
+ * @param asset_id unique id of the new asset
+ * @param exchange_id unique id of the exchange the asset is on
+ * @param broker_id unique id of the broker the asset is listed on
+ * @param warmup number of rows to skip
+ * @param datetime_column name of the datetime column (case insensitive), empty uses the first column
+ * @param epoch_unit unit of integer or float datetime columns, one of s, ms, us, ns
+ *        (timestamp and date columns carry their own unit)
+ * @return shared_ptr<Asset> new asset holding the file's data
+ */
+shared_ptr<Asset> read_feather_file(
+    const string &path,
+    const string &asset_id,
+    const string &exchange_id,
+    const string &broker_id,
+    size_t warmup = 0,
+    const string &datetime_column = "",
+    const string &epoch_unit = "ns");
+
+#endif // ARGUS_FEATHER_READER_H
@@ -0,0 +1,111 @@
+#ifndef ARGUS_FEATURE_CACHE_H
+#define ARGUS_FEATURE_CACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+/// magic bytes at the start of every cached feature file
+static constexpr char FEATURE_CACHE_MAGIC[8] = {'A', 'R', 'G', 'U', 'S', 'F', 'C', '\0'};
+
+/// version of the cached feature file format, bumping it invalidates every existing entry
+static constexpr uint32_t FEATURE_CACHE_VERSION = 1;
+
+/**
+ * @brief fixed size header of a cached feature file. The file layout is
+ *
+ *        [header][pad][values]
+ *
+ *        where values is rows doubles starting at a 64 byte aligned offset so the file can be
+ *        mapped and read in place.
+ */
+struct FeatureCacheHeader
+{
+    /// FEATURE_CACHE_MAGIC
+    char magic[8];
+
+    /// file format version
+    uint32_t version;
+
+    /// reserved for future use
+    uint32_t flags;
+
+    /// fingerprint of the feature's definition and input data
+    uint64_t key;
+
+    /// number of values in the file
+    uint64_t rows;
+
+    /// byte offset of the values
+    uint64_t data_offset;
+};
+
+/**
+ * @brief 64 bit fingerprint of a block of memory, not cryptographic. Words are mixed in four
+ *        independent lanes so hashing runs close to memory bandwidth.
+ *
+ * @param data start of the memory to hash
+ * @param size number of bytes to hash
+ * @param seed previous fingerprint to chain from, 0 to start a new one
+ * @return uint64_t fingerprint of the memory
+ */
+uint64_t fingerprint(const void *data, size_t size, uint64_t seed = 0);
+
+/**
+ * @brief directory of computed feature columns keyed by a fingerprint of the feature's definition
+ *        and the data it was computed from. A change to either gives a new key, so stale entries
+ *        are never read (they are left on disk until the directory is cleared).
+ */
+class FeatureCache
+{
+public:
+    /// use the given directory for the cache, created if it does not exist
+    explicit FeatureCache(string dir_path);
+
+    /**
+     * @brief read a cached feature
+     *
+     * @param key fingerprint of the feature
+     * @param rows expected number of values
+     * @param out buffer of rows values to copy the feature to
+     * @return bool was the feature in the cache
+     */
+    bool load(uint64_t key, size_t rows, double *out);
+
+    /**
+     * @brief write a feature to the cache, written to a temporary file first so concurrent readers
+     *        never see a partial entry
+     *
+     * @param key fingerprint of the feature
+     * @param values values of the feature
+     * @param rows number of values
+     */
+    void store(uint64_t key, const double *values, size_t rows) const;
+
+    /// directory the cache is stored in
+    [[nodiscard]] const string &get_dir_path() const { return this->dir_path; }
+
+    /// number of features read from the cache
+    [[nodiscard]] size_t get_hits() const { return this->hits; }
+
+    /// number of features that were not in the cache
+    [[nodiscard]] size_t get_misses() const { return this->misses; }
+
+private:
+    /// directory the cache is stored in
+    string dir_path;
+
+    /// number of features read from the cache
+    atomic<size_t> hits{0};
+
+    /// number of features that were not in the cache
+    atomic<size_t> misses{0};
+
+    /// location of the entry for a key
+    [[nodiscard]] string entry_path(uint64_t key) const;
+};
+
+#endif // ARGUS_FEATURE_CACHE_H
@@ -10,7 +10,9 @@
 #include <memory>
 #include <tsl/robin_map.h>
 
+#include "arena.h"
 #include "asset.h"
+#include "datetime_index.h"
 #include "exchange.h"
 #include "account.h"
 #include "portfolio.h"
@@ -40,7 +42,10 @@ private:
     long long hydra_time;
 
     /// master datetime index of the combined exchanges
-    long long *datetime_index{};
+    long long const *datetime_index = nullptr;
+
+    /// interned master datetime index, shared with an exchange with the same index
+    datetime_index_sp_t datetime_index_sp;
 
     /// current index of the datetime
     size_t current_index = 0;
@@ -51,6 +56,22 @@ private:
     /// total number of rows in the hydra across all exchanges
     size_t candles = 0;
 
+    /// exchanges with a bar at each position of the datetime index, the ones at position i are
+    /// exchange_schedule[exchange_schedule_offsets[i] : exchange_schedule_offsets[i + 1]]
+    vector<Exchange *> exchange_schedule;
+
+    /// start of each position's exchanges in exchange_schedule, datetime_index_length + 1 entries
+    vector<size_t> exchange_schedule_offsets;
+
+    /// build the exchange schedule from the datetime index of every exchange
+    void build_exchange_schedule();
+
+    /// arena holding the data of the assets that owned their buffers at the last build
+    shared_ptr<Arena> arena;
+
+    /// back the arena with transparent huge pages
+    bool huge_pages = false;
+
     // function calls on open
     vector<shared_ptr<Strategy>> strategies;
 
@@ -72,6 +93,13 @@ public:
     /// build all members
     void build();
 
+    /**
+     * @brief extend a built hydra after rows were appended to its assets without rebuilding it. The new
+     *        timestamps are merged into the exchange and hydra datetime indexes, portfolios, tracers and
+     *        the current position in time are kept so a run can continue over the new rows.
+     */
+    void extend();
+
     /// reset all members
     void reset(bool clear_history = true, bool clear_strategies = false);
 
@@ -96,7 +124,9 @@ public:
     void run(long long to = 0, size_t steps = 0);
 
     /**
-     * @brief move simulation forward to an exact moment in the datetime indx
+     * @brief move the simulation to a moment in the datetime index, forward or backward in time.
+     *        The next bar is the first one at or after the datetime, every asset's row and every
+     *        exchange's market view are moved with it. Found by binary search.
      * 
      * @param datetime ns epoch datetime to go to
      */
@@ -147,6 +177,12 @@ public:
     /// total number of rows loaded
     size_t get_candles(){return this->candles;}
 
+    /// back the arena asset data is moved into on build with transparent huge pages
+    void set_huge_pages(bool huge_pages_){this->huge_pages = huge_pages_;}
+
+    /// bytes of asset data held in the arena built by the last build
+    size_t get_arena_size(){return this->arena ? this->arena->get_size() : 0;}
+
     /// get numpy array read only view into the simulations's datetime index
     py::array_t<long long> get_datetime_index_view();
     
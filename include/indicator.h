@@ -0,0 +1,126 @@
+#ifndef ARGUS_INDICATOR_H
+#define ARGUS_INDICATOR_H
+
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/// indicator computed online as an asset steps forward
+enum IndicatorType
+{
+    Sma,      // simple moving average of the last window rows
+    Ema,      // exponentially weighted mean with a span of window rows
+    Variance, // sample variance of the last window rows
+    Minimum,  // minimum of the last window rows
+    Maximum,  // maximum of the last window rows
+    Atr       // average true range over window rows, reads high, low and close
+};
+
+/// number of columns an indicator of the given type reads
+size_t indicator_input_count(IndicatorType type);
+
+/**
+ * @brief indicator updated in O(1) per row. Values match the build-time expression functions of the
+ *        same name (rolling_mean, ewm, rolling_min, ...): rows without a full window are nan, as are
+ *        windows containing a nan.
+ */
+class OnlineIndicator
+{
+public:
+    /**
+     * @brief create an indicator with empty state
+     *
+     * @param type what the indicator computes
+     * @param window number of rows in the indicator's window (span of an ema), must be > 0
+     */
+    OnlineIndicator(IndicatorType type, size_t window);
+
+    /**
+     * @brief add the next row to the indicator
+     *
+     * @param values the indicator's inputs at the row, high, low and close for an atr
+     */
+    void update(const double *values);
+
+    /// value of the indicator after the last row added
+    [[nodiscard]] double get_value() const { return this->value; }
+
+    /// type of the indicator
+    [[nodiscard]] IndicatorType get_type() const { return this->type; }
+
+    /// number of rows in the indicator's window
+    [[nodiscard]] size_t get_window() const { return this->window; }
+
+    /// clear the indicator's state as if no rows were added
+    void reset();
+
+private:
+    /// what the indicator computes
+    IndicatorType type;
+
+    /// number of rows in the indicator's window
+    size_t window;
+
+    /// value after the last row added
+    double value;
+
+    /// number of rows added
+    size_t count = 0;
+
+    /// inputs of the last window rows, ring buffer indexed by row % window
+    vector<double> history;
+
+    /// number of nan values in the window
+    size_t nan_count = 0;
+
+    /// number of non-nan values in the window, number of true ranges added to an atr
+    size_t valid_count = 0;
+
+    /// running mean of the non-nan values in the window, the current average of an atr
+    double mean = 0;
+
+    /// running sum of squared deviations from the mean of the non-nan values in the window
+    double m2 = 0;
+
+    /// rows of the window's minimum or maximum candidates, values are monotonic front to back
+    deque<size_t> extremes;
+
+    /// decayed weighted sum of an ema's inputs, sum of the first window true ranges of an atr
+    double numerator = 0;
+
+    /// decayed sum of an ema's weights
+    double denominator = 0;
+
+    /// close of the previous row of an atr
+    double previous_close;
+
+    /// add the next row to a simple moving average or variance
+    void update_moments(double input);
+
+    /// add the next row to a rolling minimum or maximum
+    void update_extreme(double input, bool is_minimum);
+
+    /// add the next row to an exponentially weighted mean
+    void update_ema(double input);
+
+    /// add the next row to an average true range
+    void update_atr(double high, double low, double close);
+};
+
+/// online indicator reading columns of an asset
+struct AssetIndicator
+{
+    /// name the indicator is read by
+    string name;
+
+    /// column indices of the indicator's inputs
+    vector<size_t> columns;
+
+    /// the indicator's state
+    OnlineIndicator indicator;
+};
+
+#endif // ARGUS_INDICATOR_H
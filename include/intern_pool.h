@@ -0,0 +1,88 @@
+#ifndef ARGUS_INTERN_POOL_H
+#define ARGUS_INTERN_POOL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+using namespace std;
+
+/**
+ * @brief process wide pool of the immutable values alive, keyed by their hash. The pool only holds
+ *        weak references, entries of values that have been released are purged lazily.
+ */
+template <typename T>
+class InternPool
+{
+public:
+    /**
+     * @brief get the alive value with a hash that is_equal matches, or add a new one built by make
+     *
+     * @param hash hash of the value to look up
+     * @param is_equal predicate taking a const T& and returning if it equals the value looked up
+     * @param make function building the new value, returns a T* or a shared_ptr to it
+     */
+    template <typename IsEqual, typename Make>
+    shared_ptr<const T> intern(size_t hash, IsEqual is_equal, Make make)
+    {
+        lock_guard<mutex> lock(this->pool_mutex);
+        auto range = this->values.equal_range(hash);
+        for (auto it = range.first; it != range.second;)
+        {
+            auto value = it->second.lock();
+            if (!value)
+            {
+                it = this->values.erase(it);
+                continue;
+            }
+            if (is_equal(*value))
+            {
+                return value;
+            }
+            ++it;
+        }
+
+        this->purge();
+        auto value = shared_ptr<const T>(make());
+        this->values.emplace(hash, value);
+        return value;
+    }
+
+    /// number of alive values in the pool
+    size_t size()
+    {
+        lock_guard<mutex> lock(this->pool_mutex);
+        return std::count_if(this->values.begin(), this->values.end(), [](const auto &entry) {
+            return !entry.second.expired();
+        });
+    }
+
+private:
+    /// guards the pool, assets are loaded on multiple threads
+    mutex pool_mutex;
+
+    /// weak references to the values keyed by their hash
+    unordered_multimap<size_t, weak_ptr<const T>> values;
+
+    /// size of the pool at which released entries are swept out
+    size_t purge_size = 64;
+
+    /// remove the entries of released values once the pool has doubled in size since the last sweep
+    void purge()
+    {
+        if (this->values.size() < this->purge_size)
+        {
+            return;
+        }
+        for (auto it = this->values.begin(); it != this->values.end();)
+        {
+            it = it->second.expired() ? this->values.erase(it) : std::next(it);
+        }
+        this->purge_size = std::max<size_t>(64, 2 * this->values.size());
+    }
+};
+
+#endif // ARGUS_INTERN_POOL_H
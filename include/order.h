@@ -10,12 +10,16 @@ class Portfolio;
 
 #include <string>
 #include <vector>
+#include <cstdint>
 #include <memory>
 
 using namespace std;
 
 class Order;
 
+/// market id of an order whose asset has not been resolved by an exchange yet
+static constexpr size_t ORDER_NO_MARKET_ID = SIZE_MAX;
+
 /**
  * @brief An enumeration representing different order types
  * 
@@ -139,6 +143,9 @@ private:
     /// unique id of the underlying asset of the order
     string asset_id;
 
+    /// dense id of the underlying asset on it's exchange, resolved when the exchange first sees the order
+    size_t market_id = ORDER_NO_MARKET_ID;
+
     /// unique id of the exchange that the asset is on
     string exchange_id;
 
@@ -166,6 +173,12 @@ public:
     /// get the unique asset id of the order
     [[nodiscard]] string const & get_asset_id() const { return this->asset_id; }
 
+    /// get the dense id of the asset on it's exchange, ORDER_NO_MARKET_ID until the exchange resolves it
+    [[nodiscard]] size_t get_market_id() const { return this->market_id; }
+
+    /// set the dense id of the asset on it's exchange
+    inline void set_market_id(size_t market_id_) { this->market_id = market_id_; }
+
     /// get the unique broker id of the broker the order was placed to
     [[nodiscard]] string const & get_broker_id() const { return this->broker_id; }
 
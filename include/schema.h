@@ -0,0 +1,78 @@
+#ifndef ARGUS_SCHEMA_H
+#define ARGUS_SCHEMA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <tsl/robin_map.h>
+
+using namespace std;
+
+/// column index returned by Schema::find for a name that is not in the schema
+static constexpr size_t SCHEMA_NO_COLUMN = SIZE_MAX;
+
+/**
+ * @brief immutable ordered set of column names. Schemas are interned, every asset with identical
+ *        columns shares a single reference counted copy, so column indices resolved once are valid
+ *        for every asset on the same schema.
+ */
+class Schema
+{
+public:
+    /// create a new schema from its column names, use intern_schema to share it
+    explicit Schema(vector<string> columns);
+
+    Schema(const Schema &) = delete;
+    Schema &operator=(const Schema &) = delete;
+
+    /// names of the columns ordered by column index
+    [[nodiscard]] const vector<string> &get_columns() const { return this->columns; }
+
+    /// number of columns in the schema
+    [[nodiscard]] size_t get_size() const { return this->columns.size(); }
+
+    /// hash of the column names
+    [[nodiscard]] size_t get_hash() const { return this->hash; }
+
+    /// index of a column, SCHEMA_NO_COLUMN if the schema does not have it
+    [[nodiscard]] size_t find(const string &column) const
+    {
+        auto it = this->indices.find(column);
+        return it == this->indices.end() ? SCHEMA_NO_COLUMN : it->second;
+    }
+
+    /// does the schema have a column with the given name
+    [[nodiscard]] bool has_column(const string &column) const { return this->indices.count(column) > 0; }
+
+private:
+    /// names of the columns ordered by column index
+    vector<string> columns;
+
+    /// map between column name and column index
+    tsl::robin_map<string, size_t> indices;
+
+    /// hash of the column names, used to look up the schema in the pool
+    size_t hash;
+};
+
+typedef shared_ptr<const Schema> schema_sp_t;
+
+/// hash an ordered list of column names
+size_t hash_schema(const vector<string> &columns);
+
+/**
+ * @brief get the shared copy of a schema, a new one is added to the pool if no identical schema is
+ *        alive. Two interned schemas are equal if and only if their pointers are. Throws
+ *        std::runtime_error if a column name appears twice.
+ *
+ * @param columns names of the columns ordered by column index
+ * @return schema_sp_t shared schema, it is released from the pool once the last reference is dropped
+ */
+schema_sp_t intern_schema(const vector<string> &columns);
+
+/// number of distinct schemas alive in the pool
+size_t get_interned_schema_count();
+
+#endif // ARGUS_SCHEMA_H
@@ -4,12 +4,16 @@
 
 #ifndef ARGUS_UTILS_ARRAY_H
 #define ARGUS_UTILS_ARRAY_H
-#include <queue>
+#include <algorithm>
 #include <span>
 #include <memory>
+#include <utility>
+#include <vector>
 #include <pybind11/pybind11.h>
 #include <pybind11/numpy.h>
 
+#include "utils_thread.h"
+
 using namespace std;
 
 namespace py = pybind11;
@@ -65,132 +69,126 @@ bool array_eq(T const * a, T const * b, size_t length){
     return true;
 }
 
-template<class T>
-tuple<T* , int> sorted_union(T const * a, T const* b, size_t n, size_t m) {
-    int i = 0, j = 0, k = 0;
-    auto* result = new T[n + m];
-    priority_queue<T, vector<T>, greater<>> pq;
-
-    while (i < n && j < m) {
-        if (a[i] < b[j]) {
-            pq.push(a[i]);
-            i++;
-        } else if (b[j] < a[i]) {
-            pq.push(b[j]);
-            j++;
-        } else {
-            pq.push(a[i]);
-            i++;
-            j++;
-        }
-    }
-
-    while (i < n) {
-        pq.push(a[i]);
-        i++;
-    }
+/// number of arrays merged at once, larger unions are merged in rounds of this many arrays
+static constexpr size_t UNION_FAN_IN = 16;
 
-    while (j < m) {
-        pq.push(b[j]);
-        j++;
-    }
+/// number of arrays at which the merges of a round are spread over a thread pool
+static constexpr size_t PARALLEL_UNION_MIN_SOURCES = 512;
 
-    while (!pq.empty()) {
-        result[k] = pq.top();
-        pq.pop();
-        k++;
+/**
+ * @brief single pass k-way merge of sorted arrays with duplicate values removed. The arrays are
+ *        merged through a binary min heap of cursors, so the merge is O(N log k) for N values
+ *        over k arrays.
+ *
+ * @param sources pointer and length of each sorted array
+ * @param scratch buffer the union is merged into before it is copied out, reuse it across merges
+ *        to keep its allocation
+ * @return vector<T> sorted union of the arrays, sized exactly
+ */
+template<class T>
+vector<T> kway_sorted_union(const vector<pair<T const *, size_t>> &sources, vector<T> &scratch)
+{
+    // cursor into each non-empty source, heap ordered on the value each cursor points to
+    vector<pair<T const *, T const *>> heap;
+    size_t upper_bound = 0;
+    for (const auto &source : sources) {
+        if (source.second) {
+            heap.emplace_back(source.first, source.first + source.second);
+            upper_bound = std::max(upper_bound, source.second);
+        }
     }
+    auto greater_cursor = [](const auto &a, const auto &b) { return *a.first > *b.first; };
+    std::make_heap(heap.begin(), heap.end(), greater_cursor);
+
+    // the union is at least as long as the longest source, the scratch buffer keeps any growth past
+    // that for the next merge and the result is copied out at its exact size
+    auto &result = scratch;
+    result.clear();
+    result.reserve(upper_bound);
+    while (!heap.empty()) {
+        auto &top = heap.front();
+        auto value = *top.first;
+        if (result.empty() || result.back() != value) {
+            result.push_back(value);
+        }
 
-    // Shrink the memory block to the actual size needed
-    auto* temp = (T*)realloc(result, k * sizeof(T));
-    if (temp != nullptr) {
-        result = temp;
-    } else{
-        throw std::runtime_error("failed to realloc array");
+        // advance the smallest cursor and sift it down in place instead of a pop and push
+        if (++top.first == top.second) {
+            std::pop_heap(heap.begin(), heap.end(), greater_cursor);
+            heap.pop_back();
+            continue;
+        }
+        size_t i = 0;
+        size_t n = heap.size();
+        while (true) {
+            auto child = 2 * i + 1;
+            if (child >= n) {
+                break;
+            }
+            if (child + 1 < n && *heap[child + 1].first < *heap[child].first) {
+                child++;
+            }
+            if (!(*heap[child].first < *heap[i].first)) {
+                break;
+            }
+            std::swap(heap[i], heap[child]);
+            i = child;
+        }
     }
-    return std::make_tuple(result, k);
+    return vector<T>(result.begin(), result.end());
 }
 
 /**
- * Returns a sorted array of each each element's child array
+ * Returns the sorted union of each element's child array
  *
  * @param hash_map the container holding the elements to iterate over
- * @return pointer to dynamically allocated array
+ * @return sorted array without duplicates, sized exactly
  *
  * @tparam Hashmap The type of the container. It must support iteration over its values.
  * @tparam IndexLoc function to call on container elements to get array location
  * @tparam IndexLen function to call on container elements to get array length
  */
 template<typename Hashmap, typename IndexLoc, typename IndexLen>
-tuple<long long* , int> inline container_sorted_union(
+vector<long long> inline container_sorted_union(
         Hashmap& hash_map,
         IndexLoc index_loc,
         IndexLen index_len) {
-    //allocate location for new sorted array
-    auto* sorted_array = new long long[0];
-    size_t length = 0;
-
+    // interned indexes that are equal share a pointer, each is only merged once
+    vector<pair<long long const *, size_t>> sources;
     for(const auto & it : hash_map) {
-        auto element = it.second;
-
-        if(length == index_len(element)){
-            if(array_eq( sorted_array,index_loc(element),length)){
-                continue;
+        sources.emplace_back(index_loc(it.second), static_cast<size_t>(index_len(it.second)));
+    }
+    std::sort(sources.begin(), sources.end());
+    sources.erase(std::unique(sources.begin(), sources.end()), sources.end());
+
+    // merge in rounds of UNION_FAN_IN arrays, a small heap stays in cache and every round streams
+    // through memory. The merges of a round are independent and run in parallel for large universes
+    auto threads = sources.size() >= PARALLEL_UNION_MIN_SOURCES ? 0 : 1;
+    vector<vector<long long>> unions;
+    while(sources.size() > UNION_FAN_IN){
+        auto groups = (sources.size() + UNION_FAN_IN - 1) / UNION_FAN_IN;
+        vector<vector<long long>> group_unions(groups);
+        auto workers = resolve_thread_count(threads, groups);
+        parallel_for(workers, workers, [&](size_t w){
+            // each worker merges every workers-th group through one scratch buffer
+            vector<long long> scratch;
+            for(size_t g = w; g < groups; g += workers){
+                auto first = sources.begin() + g * UNION_FAN_IN;
+                auto last = sources.begin() + std::min(sources.size(), (g + 1) * UNION_FAN_IN);
+                group_unions[g] = kway_sorted_union(vector<pair<long long const *, size_t>>(first, last), scratch);
             }
-        }
-        //get sorted union of the two datetime indecies
-        auto sorted_index_tuple = sorted_union(
-                sorted_array, index_loc(element),
-                length,       index_len(element));
-
-        auto sorted_index = get<0>(sorted_index_tuple);
-        auto sorted_index_size = get<1>(sorted_index_tuple);
-
-        //swap pointers between the new sorted union and the existing one
-        std::swap(sorted_array , sorted_index);
-        length = sorted_index_size;
-
-        delete [] sorted_index;
-    }
-    return std::make_tuple(sorted_array, length);
-}
+        });
 
-template <typename T>
-class FixedDeque {
-public:
-    explicit FixedDeque(size_t max_size)
-        : max_size_(max_size) {
-    }
-
-    void push_back(const T& value) {
-        if (data_.size() == max_size_) {
-            data_.pop_front();
+        // the previous round's unions are only released once the sources no longer point to them
+        unions = std::move(group_unions);
+        sources.clear();
+        for(const auto & group_union : unions){
+            sources.emplace_back(group_union.data(), group_union.size());
         }
-        data_.push_back(value);
-    }
-
-    void clear()
-    {
-        this->data_.clear();
-    }
-
-    size_t size() const {
-        return data_.size();
-    }
-
-    const T& operator[](size_t index) const {
-        return data_[index];
     }
-
-    T& operator[](size_t index) {
-        return data_[index];
-    }
-
-private:
-    std::deque<T> data_;
-    size_t max_size_;
-};
-
+    vector<long long> scratch;
+    return kway_sorted_union(sources, scratch);
+}
 
 #endif //ARGUS_UTILS_ARRAY_H
 
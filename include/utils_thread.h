@@ -0,0 +1,83 @@
+#ifndef ARGUS_UTILS_THREAD_H
+#define ARGUS_UTILS_THREAD_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/// number of worker threads to use, 0 means one per hardware thread
+inline size_t resolve_thread_count(size_t threads, size_t tasks)
+{
+    if (threads == 0)
+    {
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    return std::max<size_t>(1, std::min(threads, tasks));
+}
+
+/**
+ * @brief run func(i) for every i in [0, n) on a pool of worker threads. Workers pull the next
+ *        index from a shared counter so uneven tasks (i.e. files of different sizes) balance out.
+ *        The first exception thrown by any task is rethrown on the calling thread once all
+ *        workers have joined.
+ *
+ * @param n number of tasks
+ * @param threads number of worker threads, 0 means one per hardware thread
+ * @param func function to call with each task index
+ */
+template <typename Func>
+void parallel_for(size_t n, size_t threads, Func func)
+{
+    if (n == 0)
+    {
+        return;
+    }
+    threads = resolve_thread_count(threads, n);
+
+    std::atomic<size_t> next_index{0};
+    std::vector<std::exception_ptr> errors(threads);
+    auto worker = [&](size_t worker_index)
+    {
+        try
+        {
+            for (size_t i = next_index++; i < n; i = next_index++)
+            {
+                func(i);
+            }
+        }
+        catch (...)
+        {
+            // stop handing out work and keep the error for the calling thread
+            errors[worker_index] = std::current_exception();
+            next_index = n;
+        }
+    };
+
+    // the calling thread does its share of the work as worker 0
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (size_t t = 1; t < threads; t++)
+    {
+        pool.emplace_back(worker, t);
+    }
+    worker(0);
+    for (auto &thread : pool)
+    {
+        thread.join();
+    }
+
+    for (auto &error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+#endif // ARGUS_UTILS_THREAD_H
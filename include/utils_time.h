@@ -9,5 +9,8 @@
 
 std::string nanosecond_epoch_time_to_string(long long ns_epoch_time);
 
+/// conversion factor from an epoch unit (s, ms, us, ns) to nanoseconds
+long long epoch_unit_scale(const std::string &epoch_unit);
+
 
 #endif //ARGUS_UTILS_TIME_H
@@ -0,0 +1,68 @@
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+
+#include <sys/mman.h>
+
+#include "fmt/core.h"
+
+#include "arena.h"
+#include "settings.h"
+
+using namespace std;
+
+/// size of a transparent huge page on x86-64 and aarch64 with 4k base pages
+static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+Arena::Arena(size_t capacity_, bool huge_pages)
+{
+    // huge pages are only used for whole 2MB extents, round the mapping up so the tail gets one too
+    this->capacity = huge_pages ? (capacity_ + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1) : capacity_;
+    if (this->capacity == 0)
+    {
+        return;
+    }
+
+    void *mapping = mmap(nullptr, this->capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED)
+    {
+        ARGUS_RUNTIME_ERROR(fmt::format("failed to map arena of {} bytes: {}", this->capacity, strerror(errno)));
+    }
+    this->data = static_cast<char *>(mapping);
+
+#ifdef MADV_HUGEPAGE
+    if (huge_pages)
+    {
+        // advice is only a hint, failure is not an error
+        madvise(this->data, this->capacity, MADV_HUGEPAGE);
+    }
+#endif
+
+#ifdef DEBUGGING
+    printf("MEMORY:   mapped arena of %zu bytes at: %p \n", this->capacity, this->data);
+#endif
+}
+
+Arena::~Arena()
+{
+#ifdef DEBUGGING
+    printf("MEMORY:   unmapping arena at: %p \n", this->data);
+#endif
+    if (this->data)
+    {
+        munmap(this->data, this->capacity);
+    }
+}
+
+void *Arena::allocate(size_t bytes)
+{
+    // the mapping is page aligned so aligned offsets give aligned addresses
+    auto block_size = arena_align(bytes);
+    if (block_size > this->capacity - this->size)
+    {
+        ARGUS_RUNTIME_ERROR(fmt::format("arena out of memory allocating {} bytes", bytes));
+    }
+    auto block = this->data + this->size;
+    this->size += block_size;
+    return block;
+}
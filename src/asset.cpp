@@ -1,4 +1,5 @@
 #include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <optional>
 #include <string>
@@ -8,6 +9,7 @@
 #include "algorithm"
 
 #include "asset.h"
+#include "asset_stream.h"
 #include "settings.h"
 #include "utils_string.h"
 #include "fmt/core.h"
@@ -18,6 +20,27 @@ using namespace std;
 
 using asset_sp_t = Asset::asset_sp_t;
 
+/// size in bytes of a value stored as the given column type
+static size_t column_type_size(AssetColumnType type)
+{
+    return type == Float64 ? sizeof(double) : sizeof(int32_t);
+}
+
+/// quantize a value into a scaled int32 column
+static int32_t quantize_value(double value, double scale)
+{
+    if (std::isnan(value))
+    {
+        return INT32_MIN;
+    }
+    auto quantized = std::llround(value / scale);
+    if (quantized <= INT32_MIN || quantized > INT32_MAX)
+    {
+        throw std::runtime_error("value out of range of scaled int32 column");
+    }
+    return static_cast<int32_t>(quantized);
+}
+
 Asset::Asset(string asset_id_, string exchange_id_, string broker_id_, size_t warmup_)              
 {
     this->asset_id = std::move(asset_id_);
@@ -30,6 +53,12 @@ Asset::Asset(string asset_id_, string exchange_id_, string broker_id_, size_t wa
     this->is_built = false;
 }
 
+/// allocate a buffer of doubles for an asset's data, shared with any forks of the asset
+static shared_ptr<double> new_data_buffer(size_t size)
+{
+    return shared_ptr<double>(new double[size], std::default_delete<double[]>());
+}
+
 Asset::~Asset()
 {
 
@@ -37,20 +66,7 @@ Asset::~Asset()
     printf("MEMORY:   CALLING ASSET %s DESTRUCTOR ON: %p \n", this->asset_id.c_str(), this);
 #endif
 
-    if (!this->is_built)
-    {
-        return;
-    }
-    if(this->is_view)
-    {
-        return;
-    }
-
-    // delete the underlying data
-    delete[] this->data;
-
-    // delete the datetime index
-    delete[] this->datetime_index;
+    // the data is released by its owner once no fork holds it, the datetime index by the pool
 
 #ifdef DEBUGGING
     printf("MEMORY:   DESTRUCTOR ON: %p COMPLETE \n", this);
@@ -59,9 +75,19 @@ Asset::~Asset()
 
 void Asset::reset_asset()
 {   
-    // move datetime index and data pointer back to start
+    // move datetime index and data pointer back to start, indicators replay the warmup on the next step
     this->current_index = this->warmup;
-    this->row = &this->data[this->warmup*this->cols];
+    for (auto &asset_indicator : this->indicators)
+    {
+        asset_indicator.indicator.reset();
+    }
+    this->indicator_rows = 0;
+    if (this->stream)
+    {
+        this->seek_stream(this->warmup);
+        return;
+    }
+    this->row = this->data ? &this->data[this->warmup * this->row_stride] : nullptr;
 }
 
 string Asset::get_asset_id() const
@@ -80,12 +106,203 @@ void Asset::load_headers(const vector<std::string> &columns)
     this->open_column = std::get<0>(column_indecies);
     this->close_column = std::get<1>(column_indecies);
 
-    size_t i = 0;
-    for (const auto &column_name : columns)
+    this->schema = intern_schema(columns);
+}
+
+vector<string> Asset::get_column_names() const
+{
+    return this->schema ? this->schema->get_columns() : vector<string>();
+}
+
+size_t Asset::get_column_index(const string &column) const
+{
+    auto column_index = this->schema ? this->schema->find(column) : SCHEMA_NO_COLUMN;
+    if (column_index == SCHEMA_NO_COLUMN)
+    {
+        throw py::key_error(fmt::format("asset {} has no column {}", this->asset_id, column));
+    }
+    return column_index;
+}
+
+void Asset::copy_column(size_t column_index, double *out) const
+{
+    if (!this->is_built)
+    {
+        throw std::runtime_error("asset is not built");
+    }
+    if (column_index >= this->cols)
+    {
+        throw std::out_of_range("column index out of range");
+    }
+    if (this->stream)
+    {
+        throw std::runtime_error("can't copy a column of a streaming asset");
+    }
+
+    if (this->is_compact)
+    {
+        auto &column = this->column_storage[column_index];
+        for (size_t i = 0; i < this->rows; i++)
+        {
+            out[i] = column.get(i);
+        }
+        return;
+    }
+
+    auto column_start = &this->data[column_index * this->column_stride];
+    if (this->is_column_major)
+    {
+        std::copy(column_start, column_start + this->rows, out);
+        return;
+    }
+    for (size_t i = 0; i < this->rows; i++)
+    {
+        out[i] = column_start[i * this->row_stride];
+    }
+}
+
+void Asset::add_columns(const vector<string> &names, const double *values, bool derived)
+{
+    if (!this->is_built)
+    {
+        throw std::runtime_error("asset is not built");
+    }
+    if (this->stream || this->loader)
     {
-        this->headers.emplace(column_name, i);
-        i++;
+        throw std::runtime_error("can't add columns to a lazy or streaming asset");
     }
+    for (const auto &name : names)
+    {
+        if (this->has_column(name))
+        {
+            throw std::runtime_error(fmt::format("asset {} already has a column {}", this->asset_id, name));
+        }
+    }
+
+    auto old_cols = this->cols;
+    auto new_cols = old_cols + names.size();
+    if (this->is_compact)
+    {
+        // new columns are stored as float64 next to the existing ones
+        vector<double> merged(this->rows * new_cols);
+        for (size_t j = 0; j < old_cols; j++)
+        {
+            this->copy_column(j, &merged[j * this->rows]);
+        }
+        std::copy(values, values + this->rows * names.size(), &merged[old_cols * this->rows]);
+        this->column_storage.resize(new_cols);
+        this->load_compact_data(merged.data(), this->rows, new_cols);
+    }
+    else
+    {
+        // copy into a new buffer with the same layout and room for the new columns
+        auto buffer = new_data_buffer(this->capacity * new_cols);
+        auto new_data = buffer.get();
+        auto new_column_stride = this->is_column_major ? this->capacity : 1;
+        auto new_row_stride = this->is_column_major ? 1 : new_cols;
+        for (size_t j = 0; j < new_cols; j++)
+        {
+            for (size_t i = 0; i < this->rows; i++)
+            {
+                new_data[i * new_row_stride + j * new_column_stride] = j < old_cols
+                    ? this->data[i * this->row_stride + j * this->column_stride]
+                    : values[(j - old_cols) * this->rows + i];
+            }
+        }
+        this->data = new_data;
+        this->data_owner = std::move(buffer);
+        this->is_view = false;
+    }
+
+    auto column_names = this->schema->get_columns();
+    column_names.insert(column_names.end(), names.begin(), names.end());
+    this->schema = intern_schema(column_names);
+    this->cols = new_cols;
+    this->derived_cols = derived ? this->derived_cols + names.size() : 0;
+    this->set_layout(this->is_column_major);
+    if (this->data)
+    {
+        this->row = &this->data[this->current_index * this->row_stride];
+    }
+}
+
+void Asset::set_column_type(const string &column, AssetColumnType type, double scale)
+{
+    if (this->is_built)
+    {
+        throw std::runtime_error("column types must be set before the data is loaded");
+    }
+
+    auto column_index = this->get_column_index(column);
+
+    if (type != Float64 && (column_index == this->open_column || column_index == this->close_column))
+    {
+        throw std::runtime_error("open and close columns must be stored as float64");
+    }
+    if (type == ScaledInt32 && !(scale > 0))
+    {
+        throw std::runtime_error("scaled int32 columns require a positive scale");
+    }
+
+    if (this->column_storage.empty())
+    {
+        this->column_storage.resize(this->schema->get_size());
+    }
+    this->column_storage[column_index].type = type;
+    this->column_storage[column_index].scale = type == ScaledInt32 ? scale : 1;
+}
+
+bool Asset::has_compact_columns() const
+{
+    return std::any_of(this->column_storage.begin(), this->column_storage.end(), [](const AssetColumn &column) {
+        return column.type != Float64;
+    });
+}
+
+void Asset::load_compact_data(const double *data_, size_t rows_, size_t cols_)
+{
+    if (this->column_storage.size() != cols_)
+    {
+        throw std::runtime_error("number of columns does not match the headers");
+    }
+
+    // every column gets its own 8 byte aligned slice of a single allocation
+    vector<size_t> column_offsets(cols_);
+    size_t words = 0;
+    for (size_t j = 0; j < cols_; j++)
+    {
+        column_offsets[j] = words;
+        words += (rows_ * column_type_size(this->column_storage[j].type) + sizeof(double) - 1) / sizeof(double);
+    }
+    auto buffer = new_data_buffer(words);
+
+    for (size_t j = 0; j < cols_; j++)
+    {
+        auto &column = this->column_storage[j];
+        auto input = &data_[j * rows_];
+        auto column_start = buffer.get() + column_offsets[j];
+        column.data = column_start;
+        switch (column.type)
+        {
+        case Float32:
+            std::transform(input, input + rows_, reinterpret_cast<float *>(column_start), [](double value) {
+                return static_cast<float>(value);
+            });
+            break;
+        case ScaledInt32:
+            std::transform(input, input + rows_, reinterpret_cast<int32_t *>(column_start), [&column](double value) {
+                return quantize_value(value, column.scale);
+            });
+            break;
+        default:
+            std::copy(input, input + rows_, column_start);
+        }
+    }
+
+    // the compact buffer is shared with any forks, data and row are not used
+    this->data = nullptr;
+    this->data_owner = std::move(buffer);
+    this->is_compact = true;
 }
 
 asset_sp_t Asset::fork_view()
@@ -95,6 +312,11 @@ asset_sp_t Asset::fork_view()
     {
         ARGUS_RUNTIME_ERROR("can't fork asset that is not built");
     }
+    if(this->stream)
+    {
+        // the window is moved by whoever steps the asset, a fork could read rows that are gone
+        ARGUS_RUNTIME_ERROR("can't fork a streaming asset");
+    }
 
     auto asset_view = std::make_shared<Asset>(
         this->asset_id, 
@@ -102,32 +324,506 @@ asset_sp_t Asset::fork_view()
         this->broker_id, 
         this->warmup
     );
-    // set is_view true (don't deallocate memory on destruction)
-    asset_view->is_view = true;
-    asset_view->is_built = true;
+    // the fork is a view (doesn't deallocate memory on destruction)
     asset_view->is_alligned = this->is_alligned;
-
-    asset_view->headers = this->headers;
-    asset_view->load_view(
-        this->data, 
-        this->datetime_index,
-        this->rows, 
-        this->cols
-    );
-    asset_view->open_column = this->open_column;
-    asset_view->close_column = this->close_column;
+    asset_view->exchange_offset = this->exchange_offset;
+    asset_view->load_view_of(*this, this->data_owner);
     asset_view->current_index = this->current_index;
     asset_view->row = this->row;
+    asset_view->indicators = this->indicators;
+    asset_view->indicator_headers = this->indicator_headers;
+    asset_view->indicator_rows = this->indicator_rows;
     return asset_view;
 }
 
-void Asset::load_view(double *data_, long long *datetime_index_, size_t rows_, size_t cols_){
+asset_sp_t Asset::resample(long long interval, const string &asset_id_)
+{
+    if (!this->is_built || !this->is_resident)
+    {
+        ARGUS_RUNTIME_ERROR("can't resample asset that is not built and in memory");
+    }
+    if (this->stream)
+    {
+        ARGUS_RUNTIME_ERROR("can't resample a streaming asset");
+    }
+    if (interval <= 0)
+    {
+        throw std::runtime_error("resample interval must be greater than 0");
+    }
+
+    // rows at which a new bucket starts, the bucket of a datetime is floor(datetime / interval)
+    auto bucket_of = [interval](long long datetime)
+    {
+        auto bucket = datetime / interval;
+        return (datetime % interval < 0) ? bucket - 1 : bucket;
+    };
+    vector<size_t> bucket_starts;
+    vector<long long> resampled_index;
+    for (size_t i = 0; i < this->rows; i++)
+    {
+        if (i == 0 || bucket_of(this->get_datetime(i)) != bucket_of(this->get_datetime(i - 1)))
+        {
+            if (i > 0)
+            {
+                resampled_index.push_back(this->get_datetime(i - 1));
+            }
+            bucket_starts.push_back(i);
+        }
+    }
+    if (this->rows)
+    {
+        resampled_index.push_back(this->get_datetime(this->rows - 1));
+    }
+    auto buckets = bucket_starts.size();
+    bucket_starts.push_back(this->rows);
+
+    // column-major buffer of the aggregates, each column in one pass over the source column
+    auto column_names = this->get_column_names();
+    auto buffer = new_data_buffer(std::max<size_t>(buckets * this->cols, 1));
+    vector<double> column_buffer;
+    for (size_t j = 0; j < this->cols; j++)
+    {
+        const double *values;
+        size_t stride;
+        if (this->is_compact)
+        {
+            column_buffer.resize(this->rows);
+            this->copy_column(j, column_buffer.data());
+            values = column_buffer.data();
+            stride = 1;
+        }
+        else
+        {
+            values = &this->data[j * this->column_stride];
+            stride = this->row_stride;
+        }
+
+        auto &name = column_names[j];
+        auto is_open = case_ins_str_compare(name, "open");
+        auto is_high = case_ins_str_compare(name, "high");
+        auto is_low = case_ins_str_compare(name, "low");
+        auto is_volume = case_ins_str_compare(name, "volume");
+        auto out = buffer.get() + j * buckets;
+        for (size_t b = 0; b < buckets; b++)
+        {
+            double value = is_volume ? 0 : NAN;
+            for (size_t i = bucket_starts[b]; i < bucket_starts[b + 1]; i++)
+            {
+                auto x = values[i * stride];
+                if (std::isnan(x))
+                {
+                    continue;
+                }
+                if (is_high)
+                {
+                    value = std::fmax(value, x);
+                }
+                else if (is_low)
+                {
+                    value = std::fmin(value, x);
+                }
+                else if (is_volume)
+                {
+                    value += x;
+                }
+                else
+                {
+                    value = x;
+                    if (is_open)
+                    {
+                        break;
+                    }
+                }
+            }
+            out[b] = value;
+        }
+    }
+
+    auto resampled = std::make_shared<Asset>(asset_id_, this->exchange_id, this->broker_id, 0);
+    resampled->load_headers(column_names);
+    auto index_sp = intern_datetime_index(std::move(resampled_index));
+    resampled->load_view(buffer.get(), index_sp, buckets, this->cols, true, buffer);
+    return resampled;
+}
+
+void Asset::load_view_of(const Asset &source, shared_ptr<void> data_owner_)
+{
+    this->schema = source.schema;
+    this->open_column = source.open_column;
+    this->close_column = source.close_column;
+    this->column_storage = source.column_storage;
+    this->is_compact = source.is_compact;
+    this->datetime_index_sp = source.datetime_index_sp;
+    this->load_view(
+        source.data, 
+        source.datetime_index,
+        source.rows, 
+        source.cols,
+        source.is_column_major,
+        std::move(data_owner_)
+    );
+
+    // the source may have room for appended rows, keep its column stride
+    this->capacity = source.capacity;
+    this->set_layout(source.is_column_major);
+}
+
+void Asset::set_loader(asset_loader_t loader_)
+{
+    if (this->is_built)
+    {
+        throw std::runtime_error("can't make an asset that is already built lazy");
+    }
+    this->loader = std::move(loader_);
+}
+
+void Asset::page_in()
+{
+    if (!this->loader)
+    {
+        throw std::runtime_error("asset does not have a loader");
+    }
+    if (this->is_resident)
+    {
+        return;
+    }
+
+    auto source = this->loader();
+    if (!source || !source->is_built)
+    {
+        ARGUS_RUNTIME_ERROR(fmt::format("loader of asset {} did not return a built asset", this->asset_id));
+    }
+
+    // the first page in pins the datetime index, after that the data must line up with it
+    auto pinned_index = this->datetime_index_sp;
+    if (pinned_index && pinned_index->get_size() != source->rows)
+    {
+        ARGUS_RUNTIME_ERROR(fmt::format("asset {} loaded a different number of rows", this->asset_id));
+    }
+    if (!pinned_index)
+    {
+        pinned_index = source->datetime_index_sp 
+            ? source->datetime_index_sp 
+            : intern_datetime_index(source->datetime_index, source->rows);
+    }
+
+    // the loaded asset owns the data, keep it alive for as long as this asset is resident
+    this->load_view_of(*source, source);
+    this->set_interned_datetime_index(pinned_index);
+    this->row = this->data ? &this->data[this->current_index * this->row_stride] : nullptr;
+}
+
+void Asset::page_out()
+{
+    if (!this->loader || !this->is_resident)
+    {
+        return;
+    }
+
+    // dropping the owner releases the loaded asset and its data, the index stays pinned
+    this->data = nullptr;
+    this->row = nullptr;
+    this->data_owner.reset();
+    this->column_storage.clear();
+    this->is_compact = false;
+    this->is_resident = false;
+}
+
+size_t Asset::get_owned_data_size() const
+{
+    if (!this->is_built || this->is_view || this->is_compact)
+    {
+        return 0;
+    }
+    return this->capacity * this->cols * sizeof(double);
+}
+
+void Asset::move_data(double *destination, shared_ptr<void> owner)
+{
+    if (!this->get_owned_data_size())
+    {
+        throw std::runtime_error("asset does not own its data");
+    }
+
+    std::copy(this->data, this->data + this->capacity * this->cols, destination);
+    auto row_offset = this->row - this->data;
+
+    // the asset is now a view of the destination, kept alive by its owner, forks keep the old buffer
+    this->data = destination;
+    this->row = this->data + row_offset;
+    this->data_owner = std::move(owner);
+    this->is_view = true;
+}
+
+AssetValidationReport Asset::validate()
+{
+    if (!this->is_built)
+    {
+        throw std::runtime_error("asset is not built");
+    }
+
+    AssetValidationReport report;
+    report.asset_id = this->asset_id;
+    report.rows = this->rows;
+    if (this->datetime_index)
+    {
+        // regular indexes are strictly increasing by construction
+        validate_datetime_index(this->datetime_index, this->rows, report);
+    }
+
+    if (this->is_compact)
+    {
+        // open and close are always stored as float64
+        auto open_values = static_cast<const double *>(this->column_storage[this->open_column].data);
+        auto close_values = static_cast<const double *>(this->column_storage[this->close_column].data);
+        validate_prices(open_values, this->rows, 1, report.invalid_open);
+        validate_prices(close_values, this->rows, 1, report.invalid_close);
+        report.prices_checked = true;
+    }
+    else if (this->is_resident && !this->stream)
+    {
+        validate_prices(&this->data[this->open_column * this->column_stride], this->rows, this->row_stride, report.invalid_open);
+        validate_prices(&this->data[this->close_column * this->column_stride], this->rows, this->row_stride, report.invalid_close);
+        report.prices_checked = true;
+    }
+
+    report.is_checked = true;
+    this->validation_report = report;
+    return report;
+}
+
+void Asset::load_stream(shared_ptr<AssetStream> stream_)
+{
+    if (this->is_built)
+    {
+        throw std::runtime_error("asset is already built");
+    }
+    if (this->has_compact_columns())
+    {
+        throw std::runtime_error("assets with compact column types can't be streamed");
+    }
+    if (!this->schema || stream_->get_cols() != this->schema->get_size())
+    {
+        throw std::runtime_error("stream column count does not match the asset headers");
+    }
+    if (this->warmup >= stream_->get_rows())
+    {
+        throw std::runtime_error("warmup is longer than the streamed asset");
+    }
+
+    // the datetime index is read directly from the stream's mapping, the stream outlives the asset's view of it
+    this->datetime_index = stream_->get_datetime_index();
+    this->data_owner = stream_;
+    this->stream = std::move(stream_);
+
+    // the window is column-major with a column stride of its capacity
+    this->rows = this->stream->get_rows();
+    this->cols = this->stream->get_cols();
+    this->capacity = this->rows;
+    this->is_column_major = true;
+    this->row_stride = 1;
+    this->column_stride = this->stream->get_window_capacity();
+
+    // the window belongs to the stream
+    this->is_view = true;
+    this->is_built = true;
+    this->is_resident = true;
+
+    this->current_index = this->warmup;
+    this->seek_stream(this->warmup);
+}
+
+void Asset::seek_stream(size_t row_index)
+{
+    // keep the row before the target readable, it is the current row until the next step
+    this->stream->seek(row_index ? row_index - 1 : 0);
+    this->data = this->stream->get_window();
+    this->row = &this->data[row_index - this->stream->get_window_start()];
+    this->stream_limit = this->stream->get_window_end();
+}
+
+void Asset::advance_stream()
+{
+    this->stream->advance();
+    this->row = &this->data[this->current_index - this->stream->get_window_start()];
+    this->stream_limit = this->stream->get_window_end();
+}
+
+void Asset::grow(size_t new_capacity)
+{
+    auto buffer = new_data_buffer(new_capacity * this->cols);
+    auto new_data = buffer.get();
+    if (this->is_column_major)
+    {
+        // columns move to their new stride, the tail of each column is left for new rows
+        for (size_t j = 0; j < this->cols; j++)
+        {
+            auto column_start = &this->data[j * this->column_stride];
+            std::copy(column_start, column_start + this->rows, &new_data[j * new_capacity]);
+        }
+    }
+    else
+    {
+        std::copy(this->data, this->data + this->rows * this->cols, new_data);
+    }
+
+    // the asset owns the new buffer, whatever it was viewing before is released unless a fork holds it
+    this->data = new_data;
+    this->data_owner = std::move(buffer);
+    this->is_view = false;
+    this->capacity = new_capacity;
+    this->set_layout(this->is_column_major);
+    this->row = &this->data[this->current_index * this->row_stride];
+}
+
+void Asset::append_rows(const double *data_, const long long *datetime_index_, size_t rows_)
+{
+    if (!this->is_built)
+    {
+        throw std::runtime_error("asset is not built");
+    }
+    if (this->stream || this->loader)
+    {
+        throw std::runtime_error("can't append rows to a lazy or streaming asset");
+    }
+    if (rows_ == 0)
+    {
+        return;
+    }
+    if (this->rows && datetime_index_[0] <= this->get_datetime(this->rows - 1))
+    {
+        throw std::runtime_error("appended rows must be after the asset's last row");
+    }
+
+    auto old_rows = this->rows;
+    auto new_rows = old_rows + rows_;
+    if (this->is_compact)
+    {
+        // narrow columns are re-encoded together with the new rows
+        vector<double> merged(new_rows * this->cols);
+        for (size_t j = 0; j < this->cols; j++)
+        {
+            this->copy_column(j, &merged[j * new_rows]);
+            std::copy(&data_[j * rows_], &data_[(j + 1) * rows_], &merged[j * new_rows + old_rows]);
+        }
+        this->load_compact_data(merged.data(), new_rows, this->cols);
+        this->capacity = new_rows;
+    }
+    else
+    {
+        // grow geometrically so a run of single row appends is amortized
+        if (this->is_view || new_rows > this->capacity)
+        {
+            this->grow(std::max(new_rows, 2 * this->capacity));
+        }
+        for (size_t j = 0; j < this->cols; j++)
+        {
+            for (size_t i = 0; i < rows_; i++)
+            {
+                this->data[(old_rows + i) * this->row_stride + j * this->column_stride] = data_[j * rows_ + i];
+            }
+        }
+    }
+
+    // interned indexes are immutable, the extended copy is interned in its place
+    vector<long long> extended_index(new_rows);
+    this->copy_datetime_index(0, old_rows, extended_index.data());
+    std::copy(datetime_index_, datetime_index_ + rows_, extended_index.begin() + old_rows);
+    this->set_interned_datetime_index(intern_datetime_index(std::move(extended_index)));
+    this->rows = new_rows;
+
+    // the new rows are after the last validated row, only they need to be checked
+    if (this->validation_report.is_checked)
+    {
+        AssetValidationReport appended;
+        appended.rows = rows_;
+        validate_datetime_index(datetime_index_, rows_, appended);
+        validate_prices(&data_[this->open_column * rows_], rows_, 1, appended.invalid_open);
+        validate_prices(&data_[this->close_column * rows_], rows_, 1, appended.invalid_close);
+        this->validation_report.merge(appended, old_rows);
+    }
+}
+
+void Asset::py_append_rows(const py::buffer &py_data, const py::buffer &py_datetime_index, size_t rows_)
+{
+    py::buffer_info data_info = py_data.request();
+    py::buffer_info datetime_index_info = py_datetime_index.request();
+
+    if(data_info.format != py::format_descriptor<double>::format())
+    {
+        throw std::runtime_error("asset data must be float64");
+    }
+    if(datetime_index_info.itemsize != sizeof(long long) || datetime_index_info.ndim != 1)
+    {
+        throw std::runtime_error("asset datetime index must be a 1d int64 array");
+    }
+    auto data_ = static_cast<const double *>(data_info.ptr);
+    auto source_cols = this->cols - this->derived_cols;
+    auto is_source_only = this->derived_cols && data_info.size == static_cast<py::ssize_t>(rows_ * source_cols);
+    if(datetime_index_info.shape[0] != static_cast<py::ssize_t>(rows_) 
+        || (data_info.size != static_cast<py::ssize_t>(rows_ * this->cols) && !is_source_only))
+    {
+        throw std::runtime_error("buffer sizes do not match number of rows");
+    }
+
+    // derived columns are left as nan, the exchange computes them when it is extended
+    vector<double> padded;
+    if(is_source_only)
+    {
+        padded.assign(rows_ * this->cols, NAN);
+        std::copy(data_, data_ + rows_ * source_cols, padded.begin());
+        data_ = padded.data();
+    }
+
+    this->append_rows(
+        data_, 
+        static_cast<const long long *>(datetime_index_info.ptr), 
+        rows_);
+}
+
+void Asset::set_layout(bool column_major)
+{
+    this->is_column_major = column_major;
+    if(this->is_compact)
+    {
+        // values are read through the column storage, the row pointer never moves
+        this->is_column_major = true;
+        this->row_stride = 0;
+        this->column_stride = 0;
+    }
+    else if(column_major)
+    {
+        // each column is a contiguous slice of length capacity, the tail is room for appended rows
+        this->row_stride = 1;
+        this->column_stride = this->capacity;
+    }
+    else
+    {
+        // each row is a contiguous slice of length cols
+        this->row_stride = this->cols;
+        this->column_stride = 1;
+    }
+}
+
+void Asset::load_view(
+    double *data_, 
+    long long const *datetime_index_, 
+    size_t rows_, 
+    size_t cols_, 
+    bool column_major,
+    shared_ptr<void> data_owner_)
+{
 #ifdef DEBUGGING
     printf("MEMORY: CALLING ASSET %s load_data() ON: %p \n", this->asset_id.c_str(), this);
 #endif  
+    if (!this->is_compact && this->has_compact_columns())
+    {
+        throw runtime_error("assets with compact column types can't be loaded as a view");
+    }
 
     // set data to point to the existing allocated data
     this->data = data_;
+    this->data_owner = std::move(data_owner_);
 
     // set the datetimes index to point to existing datetime index
     this->datetime_index = datetime_index_;
@@ -135,19 +831,39 @@ void Asset::load_view(double *data_, long long *datetime_index_, size_t rows_, s
     // set the asset matrix size
     this->rows = rows_;
     this->cols = cols_;
+    this->capacity = rows_;
+    this->set_layout(column_major);
 
     //is built and is a view
     this->is_view = true;
     this->is_built = true;
+    this->is_resident = true;
 
-    this->row = &this->data[0];
+    this->row = &this->data[this->warmup * this->row_stride];
 #ifdef DEBUGGING
     printf("MEMORY:   asset %s datetime index at: %p \n", this->asset_id.c_str(), this->datetime_index);
     printf("MEMORY:   asset %s load_data() allocated at: %p  \n", this->asset_id.c_str(), this);
 #endif
 }
 
-void Asset::load_data(const double *data_, const long long *datetime_index_, size_t rows_, size_t cols_)
+void Asset::load_view(
+    double *data_, 
+    datetime_index_sp_t datetime_index_, 
+    size_t rows_, 
+    size_t cols_, 
+    bool column_major,
+    shared_ptr<void> data_owner_)
+{
+    this->load_view(data_, static_cast<long long const *>(nullptr), rows_, cols_, column_major, std::move(data_owner_));
+    this->set_interned_datetime_index(std::move(datetime_index_));
+}
+
+void Asset::load_data(
+    const double *data_, 
+    const long long *datetime_index_, 
+    size_t rows_, 
+    size_t cols_, 
+    bool column_major)
 {
 #ifdef DEBUGGING
     printf("MEMORY: CALLING ASSET %s load_data() ON: %p \n", this->asset_id.c_str(), this);
@@ -157,36 +873,53 @@ void Asset::load_data(const double *data_, const long long *datetime_index_, siz
         throw runtime_error("asset is already built");
     }
 
-    // allocate data array
-    this->data = new double[rows_ * cols_];
-
-    // allocate datetime index
-    this->datetime_index = new long long[rows_];
-
     // set the asset matrix size
     this->rows = rows_;
     this->cols = cols_;
+    this->capacity = rows_;
 
-    // copy the data from a column formated 1d array ([col1_0, col1_1, col2_0, col2_1])
-    for (int j = 0; j < cols_; j++) {
-        auto input_col_start = j * rows_;
-        for (int i = 0; i < rows_; i++) {
-            auto value = data_[input_col_start + i];
-            data[i * cols_ + j] = value;
-        }
+    if(this->has_compact_columns())
+    {
+        // copy each column into storage of its own type
+        this->load_compact_data(data_, rows_, cols_);
+        this->set_layout(true);
     }
-
-    // copy the datetime index into the asset
-    for (int i = 0; i < rows_; i++)
+    else if(column_major)
     {
-        this->datetime_index[i] = datetime_index_[i];
+        // input is already column formated, copy it over as is
+        this->data_owner = new_data_buffer(rows_ * cols_);
+        this->data = static_cast<double *>(this->data_owner.get());
+        this->set_layout(column_major);
+        std::copy(data_, data_ + rows_ * cols_, this->data);
     }
+    else
+    {
+        this->data_owner = new_data_buffer(rows_ * cols_);
+        this->data = static_cast<double *>(this->data_owner.get());
+        this->set_layout(column_major);
+
+        // copy the data from a column formated 1d array ([col1_0, col1_1, col2_0, col2_1])
+        for (int j = 0; j < cols_; j++) {
+            auto input_col_start = j * rows_;
+            for (int i = 0; i < rows_; i++) {
+                auto value = data_[input_col_start + i];
+                data[i * cols_ + j] = value;
+            }
+        }
+    }
+
+    // share the datetime index with any other asset that has the same one
+    this->set_interned_datetime_index(intern_datetime_index(datetime_index_, rows_));
 
     //set row pointer to first row 
-    this->row = &this->data[this->warmup * this->cols];
+    this->row = &this->data[this->warmup * this->row_stride];
 
     // set build flag to true after copying data
     this->is_built = true;
+    this->is_resident = true;
+
+    // problems are recorded in the report, they are surfaced when the exchange is built
+    this->validate();
 
 #ifdef DEBUGGING
     printf("MEMORY:   asset %s datetime index at: %p \n", this->asset_id.c_str(), this->datetime_index);
@@ -199,9 +932,10 @@ void Asset::py_load_data(
     const py::buffer &py_datetime_index,
     size_t rows_,
     size_t cols_,
-    bool is_view)
+    bool is_view,
+    bool column_major)
 {
-    if(headers.size() == 0)
+    if(!this->schema)
     {   
         throw std::runtime_error("headers must be loaded before data");
     }
@@ -209,6 +943,19 @@ void Asset::py_load_data(
     py::buffer_info data_info = py_data.request();
     py::buffer_info datetime_index_info = py_datetime_index.request();
 
+    if(data_info.format != py::format_descriptor<double>::format())
+    {
+        throw std::runtime_error("asset data must be float64");
+    }
+    if(datetime_index_info.itemsize != sizeof(long long) || datetime_index_info.ndim != 1)
+    {
+        throw std::runtime_error("asset datetime index must be a 1d int64 array");
+    }
+    if(datetime_index_info.shape[0] != static_cast<py::ssize_t>(rows_))
+    {
+        throw std::runtime_error("datetime index length does not match number of rows");
+    }
+
     // cast the python buffers to raw pointer
     auto data_ = static_cast<double *>(data_info.ptr);
     auto datetime_index_ = static_cast<long long *>(datetime_index_info.ptr);
@@ -216,40 +963,90 @@ void Asset::py_load_data(
     // pass raw pointer to c loading function and copy data
     if(!is_view)
     {
-        this->load_data(data_, datetime_index_, rows_, cols_);
+        this->load_data(data_, datetime_index_, rows_, cols_, column_major);
+        return;
     }
-    // pass raw pointer and mirror the asset pointer to the data passed in the py buffers
-    else
+    if(this->has_compact_columns())
+    {
+        throw std::runtime_error("assets with compact column types can't be loaded as a view");
+    }
+
+    // a view can only be taken of contiguous memory, 2d buffers tell us their layout
+    auto const item_size = static_cast<py::ssize_t>(sizeof(double));
+    if(data_info.ndim == 2)
+    {
+        if(data_info.shape[0] != static_cast<py::ssize_t>(rows_) 
+            || data_info.shape[1] != static_cast<py::ssize_t>(cols_))
+        {
+            throw std::runtime_error("buffer shape does not match rows and cols");
+        }
+        if(data_info.strides[0] == item_size && data_info.strides[1] == item_size * data_info.shape[0])
+        {
+            column_major = true;
+        }
+        else if(data_info.strides[1] == item_size && data_info.strides[0] == item_size * data_info.shape[1])
+        {
+            column_major = false;
+        }
+        else
+        {
+            throw std::runtime_error("asset view requires a contiguous buffer");
+        }
+    }
+    if(datetime_index_info.strides[0] != static_cast<py::ssize_t>(sizeof(long long)))
     {
-        this->load_view(data_, datetime_index_, rows_, cols_);
+        throw std::runtime_error("asset view requires a contiguous datetime index");
     }
+
+    // pin the python objects for as long as the asset (or any fork of it) is alive
+    using py_owner_t = std::pair<py::object, py::object>;
+    auto py_owner = shared_ptr<void>(
+        new py_owner_t(py_data, py_datetime_index),
+        [](void *owner)
+        {
+            py::gil_scoped_acquire gil;
+            delete static_cast<py_owner_t *>(owner);
+        });
+
+    // pass raw pointer and mirror the asset pointer to the data passed in the py buffers
+    this->load_view(data_, datetime_index_, rows_, cols_, column_major, std::move(py_owner));
 }
 
 double Asset::c_get(size_t column_index) const
 {
+    if (this->is_compact)
+    {
+        return this->column_storage[column_index].get(this->current_index - 1);
+    }
+
     // derefence data pointer at current row plus column offset
-    return *(this->row - this->cols + column_index);
+    return *(this->row - this->row_stride + column_index * this->column_stride);
 }
 
 double Asset::get(const std::string &column, size_t row_index) const
 {
     // fetch the column index of it exists
-    size_t column_index;
-    try
+    auto column_index = this->get_column_index(column);
+    // make sure the row index is valid
+    if (row_index >= this->rows)
     {
-        column_index = this->headers.at(column);
+        throw out_of_range("row index out of range");
     }
-    catch (const std::out_of_range &e)
+    if (this->is_compact)
     {
-        // Catch the exception and re-raise it as a Python KeyError
-        throw py::key_error(e.what());
+        return this->column_storage[column_index].get(row_index);
     }
-    // make sure the row index is valid
-    if (row_index >= this->rows)
+    if (this->stream)
     {
-        throw out_of_range("row index out of range");
+        // only rows inside of the stream's window are in memory
+        auto window_start = this->stream->get_window_start();
+        if (row_index < window_start || row_index >= this->stream->get_window_end())
+        {
+            throw out_of_range("row index is outside of the streamed window");
+        }
+        row_index -= window_start;
     }
-    return this->data[row_index * this->cols + column_index];
+    return this->data[row_index * this->row_stride + column_index * this->column_stride];
 }
 
 double Asset::get_market_price(bool on_close) const
@@ -259,42 +1056,76 @@ double Asset::get_market_price(bool on_close) const
     //make sure row pointer is not out of bounds
     ptrdiff_t index = this->row - this->data; 
     auto size = this->rows * this->cols;
-    assert(index - this->cols  < size);
+    assert(index - this->row_stride  < size);
     #endif
 
-    //subtract this->cols to move back row, then get_market_view is called, asset->step()
+    // open and close are always float64, read them directly at full precision
+    if (this->is_compact)
+    {
+        auto column = on_close ? this->close_column : this->open_column;
+        return static_cast<const double *>(this->column_storage[column].data)[this->current_index - 1];
+    }
+
+    //subtract this->row_stride to move back row, then get_market_view is called, asset->step()
     //is called so we need to move back a row when accessing asset data
     if (on_close)
-        return *(this->row - this->cols + this->close_column);
+        return *(this->row - this->row_stride + this->close_column * this->column_stride);
     else
-        return *(this->row - this->cols + this->open_column);
+        return *(this->row - this->row_stride + this->open_column * this->column_stride);
 }
 
 double Asset::get_asset_feature(const string& column_name, int index)
+{
+    // names that are not columns are online indicators, only their current value is kept
+    auto column_index = this->schema ? this->schema->find(column_name) : SCHEMA_NO_COLUMN;
+    if(column_index == SCHEMA_NO_COLUMN){
+        auto indicator_offset = this->indicator_headers.find(column_name);
+        if(indicator_offset == this->indicator_headers.end()){
+            throw py::key_error(fmt::format("asset {} has no column {}", this->asset_id, column_name));
+        }
+        if(index != 0){
+            throw std::out_of_range("indicators only hold their current value");
+        }
+        return this->indicators[indicator_offset->second].indicator.get_value();
+    }
+    return this->get_asset_feature(column_index, index);
+}
+
+double Asset::get_asset_feature(size_t column_index, int index)
 {
 
     #ifdef ARGUS_RUNTIME_ASSERT
     //make sure row pointer is not out of bounds
     ptrdiff_t ptr_index = this->row - this->data; 
     auto size = this->rows * this->cols;
-    assert(ptr_index - this->cols < size);
+    assert(ptr_index - this->row_stride < size);
     assert(index <= 0);
+    assert(column_index < this->cols);
     #endif
 
-    //subtract this->cols to move back row, then get_market_view is called, asset->step()
+    //subtract this->row_stride to move back row, then get_market_view is called, asset->step()
     //is called so we need to move back a row when accessing asset data
-    auto column_offset = this->headers.find(column_name);
-    auto row_offset = static_cast<int>(this->cols) * index;
+    auto row_offset = static_cast<int>(this->row_stride) * index;
 
-    #ifdef ARGUS_RUNTIME_ASSERT
-    if(column_offset == this->headers.end()){
-        throw ARGUS_RUNTIME_ASSERT("missing column");
+    // the target row is signed so an index before the first row can't wrap around
+    auto target_row = static_cast<long long>(this->current_index) - 1 + index;
+    if (target_row < 0)
+    {
+        throw std::out_of_range("index is before the first row of the asset");
+    }
+    if (this->stream && static_cast<size_t>(target_row) < this->stream->get_window_start())
+    {
+        throw std::out_of_range("index is past the lookback of the streaming asset");
+    }
+
+    if (this->is_compact)
+    {
+        return this->column_storage[column_index].get(static_cast<size_t>(target_row));
     }
-    #endif
 
     //prevent acces index < 0
     assert(row_offset + ptr_index > 0);
-    return *(this->row - this->cols + column_offset->second + row_offset);
+    return *(this->row - this->row_stride + column_index * this->column_stride + row_offset);
 }
 
 py::array_t<double> Asset::get_column(const string& column_name, size_t length)
@@ -303,11 +1134,30 @@ py::array_t<double> Asset::get_column(const string& column_name, size_t length)
     {
         throw std::runtime_error("index out of bounds");
     }
+    if(this->stream && this->current_index - 1 - length < this->stream->get_window_start())
+    {
+        throw std::runtime_error("length is past the lookback of the streaming asset");
+    }
 
-    auto column_offset = this->headers.find(column_name);
-    auto row_offset = static_cast<int>(this->cols) * length;
+    auto column_index = this->get_column_index(column_name);
+    auto row_offset = static_cast<int>(this->row_stride) * length;
+
+    // narrow columns can't be viewed as doubles, widen the values into a new array
+    if (this->is_compact)
+    {
+        auto &column = this->column_storage[column_index];
+        auto start_index = this->current_index - 1 - length;
+        py::array_t<double> values(length);
+        auto out = values.mutable_data();
+        for (size_t i = 0; i < length; i++)
+        {
+            out[i] = column.get(start_index + i);
+        }
+        return values;
+    }
     
-    auto column_start = this->row - this->cols + column_offset->second - row_offset;
+    // column-major assets return a dense view into a contiguous column slice
+    auto column_start = this->row - this->row_stride + column_index * this->column_stride - row_offset;
     return py::array( 
         py::buffer_info
             (
@@ -316,21 +1166,38 @@ py::array_t<double> Asset::get_column(const string& column_name, size_t length)
                 py::format_descriptor<double>::format(), /* Python struct-style format descriptor */
                 1,                                      /* Number of dimensions */
                 { length },                 /* Buffer dimensions */
-                { sizeof(double) * this->cols}
+                { sizeof(double) * this->row_stride}
             )
     );
 }
 
-long long *Asset::get_datetime_index(bool warmup_start) const
+long long const *Asset::get_datetime_index(bool warmup_start) const
 {   
+    auto index = this->datetime_index ? this->datetime_index : this->datetime_index_sp->get_data();
     if(warmup_start)
     {
-        return &this->datetime_index[warmup];
+        return &index[warmup];
     }
     else
     {
-        return &this->datetime_index[0];
+        return &index[0];
+    }
+}
+
+void Asset::copy_datetime_index(size_t first, size_t count, long long *out) const
+{
+    if (this->datetime_index)
+    {
+        std::copy(this->datetime_index + first, this->datetime_index + first + count, out);
+        return;
     }
+    this->datetime_index_sp->copy_values(first, count, out);
+}
+
+void Asset::set_interned_datetime_index(datetime_index_sp_t index)
+{
+    this->datetime_index = index->is_regular() ? nullptr : index->get_data();
+    this->datetime_index_sp = std::move(index);
 }
 
 py::array_t<long long> Asset::get_datetime_index_view()
@@ -343,13 +1210,20 @@ py::array_t<long long> Asset::get_datetime_index_view()
     {
         throw std::runtime_error("no data to return");
     }
+    if (!this->datetime_index)
+    {
+        // a regular index is never expanded for the asset, the array is derived from its runs
+        py::array_t<long long> values(this->rows);
+        this->copy_datetime_index(0, this->rows, values.mutable_data());
+        return values;
+    }
     return to_py_array(
         this->datetime_index,
         this->rows,
         true);
 };
 
-long long *Asset::get_asset_time() const
+long long const *Asset::get_asset_time() const
 {
     if (this->current_index == this->rows)
     {
@@ -357,31 +1231,35 @@ long long *Asset::get_asset_time() const
     }
     else
     {
-        return &this->datetime_index[this->current_index];
+        return this->get_datetime_index() + this->current_index;
     }
 }
 
 void Asset::goto_datetime(long long datetime)
 {
-    //goto date is beyond the datetime index
-   if(datetime >= this->datetime_index[this->rows-1])
+    // first row at or after the datetime, the asset is done streaming if there is none
+    auto first = std::min(this->warmup, this->rows);
+    auto interned_index = this->get_interned_datetime_index();
+    if (interned_index)
     {
-        this->current_index = this->rows;
+        this->current_index = interned_index->lower_bound(datetime, first);
     }
-    
-    // search for datetime in the index
-    for(int i = this->current_index; i < this->rows; i++)
-    {   
-        //is >= right?
-        if(this->datetime_index[i] >= datetime)
+    else
+    {
+        auto last = this->datetime_index + this->rows;
+        this->current_index = std::lower_bound(this->datetime_index + first, last, datetime) - this->datetime_index;
+    }
+
+    // the row pointer is set from the new position, the move can be backward or forward in time
+    if (this->stream)
+    {
+        if (this->current_index < this->rows)
         {
-            this->row += (this->cols * (i-this->warmup));
-            this->current_index = i;
-            return;
+            this->seek_stream(this->current_index);
         }
+        return;
     }
-
-    throw std::runtime_error("failed to find datetime in asset goto");    
+    this->row = this->data ? &this->data[this->current_index * this->row_stride] : nullptr;
 }
 
 std::shared_ptr<Asset> new_asset(
@@ -394,9 +1272,117 @@ std::shared_ptr<Asset> new_asset(
 }
 
 void Asset::step(){
+    // a streaming asset slides its window forward once the next row is past its end
+    if (this->current_index == this->stream_limit)
+    {
+        this->advance_stream();
+    }
+
     //move the row pointer forward to the next row
-    this->row += this->cols;
+    this->row += this->row_stride;
 
     //move the current index forward
     this->current_index++; 
+
+    if (!this->indicators.empty())
+    {
+        this->update_indicators();
+    }
+}
+
+void Asset::add_indicator(const string &name, IndicatorType type, const vector<string> &columns, size_t window)
+{
+    if (this->has_column(name) || this->has_indicator(name))
+    {
+        throw std::runtime_error(fmt::format("asset {} already has a column or indicator {}", this->asset_id, name));
+    }
+    if (columns.size() != indicator_input_count(type))
+    {
+        throw std::runtime_error(fmt::format("indicator {} reads {} columns", name, indicator_input_count(type)));
+    }
+
+    vector<size_t> column_indices;
+    for (const auto &column : columns)
+    {
+        column_indices.push_back(this->get_column_index(column));
+    }
+
+    this->indicator_headers.emplace(name, this->indicators.size());
+    this->indicators.push_back(AssetIndicator{name, std::move(column_indices), OnlineIndicator(type, window)});
+
+    // every indicator is replayed from the first row so they all cover the same rows
+    for (auto &asset_indicator : this->indicators)
+    {
+        asset_indicator.indicator.reset();
+    }
+    this->indicator_rows = 0;
+}
+
+void Asset::write_column(size_t column_index, size_t first_row, const double *values, size_t count)
+{
+    if (first_row + count > this->rows)
+    {
+        throw std::out_of_range("write past the last row of the asset");
+    }
+    if (this->is_compact)
+    {
+        // the compact buffer is rebuilt on every append, forks only read rows before the new ones
+        auto &column = this->column_storage[column_index];
+        if (column.type != Float64)
+        {
+            throw std::runtime_error("only float64 columns can be written");
+        }
+        std::copy(values, values + count, const_cast<double *>(static_cast<const double *>(column.data)) + first_row);
+        return;
+    }
+    if (this->is_view || this->stream)
+    {
+        throw std::runtime_error("can't write to a view of an asset's data");
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        this->data[(first_row + i) * this->row_stride + column_index * this->column_stride] = values[i];
+    }
+}
+
+double Asset::read_value(size_t column_index, size_t row_index) const
+{
+    if (this->is_compact)
+    {
+        return this->column_storage[column_index].get(row_index);
+    }
+    if (this->stream)
+    {
+        row_index -= this->stream->get_window_start();
+    }
+    return this->data[row_index * this->row_stride + column_index * this->column_stride];
+}
+
+void Asset::update_indicators()
+{
+    // rows before a streaming asset's window are gone, the indicators restart at the window
+    size_t first_row = this->stream ? this->stream->get_window_start() : 0;
+    if (this->indicator_rows > this->current_index || this->indicator_rows < first_row)
+    {
+        for (auto &asset_indicator : this->indicators)
+        {
+            asset_indicator.indicator.reset();
+        }
+        this->indicator_rows = first_row;
+    }
+
+    // normally one row per step, more after a reset, warmup or jump forward in time
+    double inputs[3];
+    for (; this->indicator_rows < this->current_index; this->indicator_rows++)
+    {
+        for (auto &asset_indicator : this->indicators)
+        {
+            auto &columns = asset_indicator.columns;
+            for (size_t k = 0; k < columns.size(); k++)
+            {
+                inputs[k] = this->read_value(columns[k], this->indicator_rows);
+            }
+            asset_indicator.indicator.update(inputs);
+        }
+    }
 }
\ No newline at end of file
@@ -0,0 +1,313 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "fmt/core.h"
+
+#include "asset.h"
+#include "asset_file.h"
+#include "csv_reader.h"
+#include "feather_reader.h"
+#include "settings.h"
+
+using namespace std;
+
+/// round a byte offset up to the file alignment
+static uint64_t align_offset(uint64_t offset)
+{
+    return (offset + ARGUS_FILE_ALIGNMENT - 1) & ~(static_cast<uint64_t>(ARGUS_FILE_ALIGNMENT) - 1);
+}
+
+/// write zero bytes to the stream until it is at the given offset
+static void pad_to(ofstream &file, uint64_t offset)
+{
+    static const char zeros[ARGUS_FILE_ALIGNMENT] = {};
+    auto position = static_cast<uint64_t>(file.tellp());
+    file.write(zeros, static_cast<streamsize>(offset - position));
+}
+
+MappedFile::MappedFile(const string &path_) : path(path_)
+{
+    int fd = ::open(this->path.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        ARGUS_RUNTIME_ERROR(fmt::format("failed to open file {}: {}", this->path, strerror(errno)));
+    }
+
+    struct stat file_stat{};
+    if (fstat(fd, &file_stat) == -1 || file_stat.st_size == 0)
+    {
+        ::close(fd);
+        ARGUS_RUNTIME_ERROR(fmt::format("failed to stat file or file is empty: {}", this->path));
+    }
+    this->size = static_cast<size_t>(file_stat.st_size);
+
+    // shared read only mapping, the pages live in the page cache and can be shared across processes
+    void *mapping = mmap(nullptr, this->size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        ARGUS_RUNTIME_ERROR(fmt::format("failed to map file {}: {}", this->path, strerror(errno)));
+    }
+    this->data = static_cast<const char *>(mapping);
+
+#ifdef DEBUGGING
+    printf("MEMORY:   mapped file %s at: %p \n", this->path.c_str(), this->data);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef DEBUGGING
+    printf("MEMORY:   unmapping file %s at: %p \n", this->path.c_str(), this->data);
+#endif
+    if (this->data)
+    {
+        munmap(const_cast<char *>(this->data), this->size);
+    }
+}
+
+void MappedFile::advise(size_t offset, size_t length, int advice) const
+{
+    if (offset >= this->size || length == 0)
+    {
+        return;
+    }
+
+    // madvise needs a page aligned address, round the region out to whole pages
+    auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    auto start = offset & ~(page_size - 1);
+    length = std::min(length + (offset - start), this->size - start);
+
+    // advice is only a hint, failure is not an error
+    madvise(const_cast<char *>(this->data) + start, length, advice);
+}
+
+void write_asset_file(const shared_ptr<Asset> &asset, const string &path)
+{
+    if (!asset->get_is_built())
+    {
+        ARGUS_RUNTIME_ERROR("can't write asset that is not built");
+    }
+
+    auto rows = asset->get_rows();
+    auto cols = asset->get_cols();
+    auto column_names = asset->get_column_names();
+
+    // build the schema block
+    string schema;
+    for (const auto &column_name : column_names)
+    {
+        auto length = static_cast<uint32_t>(column_name.size());
+        schema.append(reinterpret_cast<const char *>(&length), sizeof(length));
+        schema.append(column_name);
+    }
+
+    ArgusFileHeader header{};
+    memcpy(header.magic, ARGUS_FILE_MAGIC, sizeof(header.magic));
+    header.version = ARGUS_FILE_VERSION;
+    header.rows = rows;
+    header.cols = cols;
+    header.schema_offset = sizeof(ArgusFileHeader);
+    header.schema_size = schema.size();
+    header.index_offset = align_offset(header.schema_offset + header.schema_size);
+    header.data_offset = align_offset(header.index_offset + rows * sizeof(long long));
+    header.file_size = header.data_offset + rows * cols * sizeof(double);
+
+    ofstream file(path, ios::binary | ios::trunc);
+    if (!file)
+    {
+        ARGUS_RUNTIME_ERROR(fmt::format("failed to open file for writing: {}", path));
+    }
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(schema.data(), static_cast<streamsize>(schema.size()));
+
+    // datetime index block
+    pad_to(file, header.index_offset);
+    vector<long long> datetime_index(rows);
+    asset->copy_datetime_index(0, rows, datetime_index.data());
+    file.write(
+        reinterpret_cast<const char *>(datetime_index.data()),
+        static_cast<streamsize>(rows * sizeof(long long)));
+
+    // column-major data block
+    pad_to(file, header.data_offset);
+    vector<double> column(rows);
+    for (size_t j = 0; j < cols; j++)
+    {
+        asset->copy_column(j, column.data());
+        file.write(
+            reinterpret_cast<const char *>(column.data()),
+            static_cast<streamsize>(rows * sizeof(double)));
+    }
+
+    if (!file)
+    {
+        ARGUS_RUNTIME_ERROR(fmt::format("failed to write file: {}", path));
+    }
+}
+
+ArgusFileHeader read_asset_file_header(const MappedFile &file, const string &path, vector<string> &column_names)
+{
+    auto file_data = file.get_data();
+    auto file_size = file.get_size();
+
+    // validate the header before touching anything else in the mapping
+    if (file_size < sizeof(ArgusFileHeader))
+    {
+        ARGUS_RUNTIME_ERROR(fmt::format("file is too small to be an argus file: {}", path));
+    }
+    ArgusFileHeader header{};
+    memcpy(&header, file_data, sizeof(header));
+
+    if (memcmp(header.magic, ARGUS_FILE_MAGIC, sizeof(header.magic)) != 0)
+    {
+        ARGUS_RUNTIME_ERROR(fmt::format("not an argus file: {}", path));
+    }
+    if (header.version != ARGUS_FILE_VERSION)
+    {
+        ARGUS_RUNTIME_ERROR(fmt::format("unsupported argus file version {}: {}", header.version, path));
+    }
+    if (header.rows == 0 || header.cols == 0)
+    {
+        ARGUS_RUNTIME_ERROR(fmt::format("argus file has no data: {}", path));
+    }
+    if (header.file_size != file_size
+        || header.schema_offset + header.schema_size > file_size
+        || header.index_offset % sizeof(long long) != 0
+        || header.data_offset % sizeof(double) != 0
+        || header.index_offset + header.rows * sizeof(long long) > header.data_offset
+        || header.data_offset + header.rows * header.cols * sizeof(double) > file_size)
+    {
+        ARGUS_RUNTIME_ERROR(fmt::format("argus file is corrupt: {}", path));
+    }
+
+    // parse the column names out of the schema block
+    column_names.clear();
+    column_names.reserve(header.cols);
+    auto schema = file_data + header.schema_offset;
+    auto schema_end = schema + header.schema_size;
+    for (uint64_t j = 0; j < header.cols; j++)
+    {
+        uint32_t length;
+        if (schema + sizeof(length) > schema_end)
+        {
+            ARGUS_RUNTIME_ERROR(fmt::format("argus file schema is corrupt: {}", path));
+        }
+        memcpy(&length, schema, sizeof(length));
+        schema += sizeof(length);
+        if (schema + length > schema_end)
+        {
+            ARGUS_RUNTIME_ERROR(fmt::format("argus file schema is corrupt: {}", path));
+        }
+        column_names.emplace_back(schema, length);
+        schema += length;
+    }
+    return header;
+}
+
+shared_ptr<Asset> read_asset_file(
+    const string &path,
+    const string &asset_id,
+    const string &exchange_id,
+    const string &broker_id,
+    size_t warmup,
+    bool prefetch)
+{
+    auto file = make_shared<MappedFile>(path);
+    auto file_data = file->get_data();
+
+    vector<string> column_names;
+    auto header = read_asset_file_header(*file, path, column_names);
+
+    // the index is read right away when the exchange is built, the data is streamed forward
+    file->advise(header.index_offset, header.rows * sizeof(long long), MADV_WILLNEED);
+    file->advise(
+        header.data_offset,
+        header.rows * header.cols * sizeof(double),
+        prefetch ? MADV_WILLNEED : MADV_SEQUENTIAL);
+
+    auto asset = make_shared<Asset>(asset_id, exchange_id, broker_id, warmup);
+    asset->load_headers(column_names);
+
+    // the mapping is read only, the asset never writes through its data pointers
+    auto datetime_index = reinterpret_cast<long long *>(const_cast<char *>(file_data + header.index_offset));
+    auto data = reinterpret_cast<double *>(const_cast<char *>(file_data + header.data_offset));
+    asset->load_view(
+        data,
+        datetime_index,
+        header.rows,
+        header.cols,
+        true,
+        std::move(file));
+
+    return asset;
+}
+
+bool is_asset_file(const string &path)
+{
+    auto extension = filesystem::path(path).extension().string();
+    return extension == ".argus" || extension == ".csv" || extension == ".feather" || extension == ".arrow";
+}
+
+vector<string> list_asset_files(const string &dir_path)
+{
+    if (!filesystem::is_directory(dir_path))
+    {
+        ARGUS_RUNTIME_ERROR(fmt::format("not a directory: {}", dir_path));
+    }
+
+    // skip anything that is not an asset file (i.e. .DS_Store)
+    vector<string> paths;
+    for (const auto &entry : filesystem::directory_iterator(dir_path))
+    {
+        if (entry.is_regular_file() && is_asset_file(entry.path().string()))
+        {
+            paths.push_back(entry.path().string());
+        }
+    }
+
+    // directory order is not defined, sort so loading is deterministic
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+string asset_id_from_path(const string &path)
+{
+    return filesystem::path(path).stem().string();
+}
+
+shared_ptr<Asset> load_asset_file(
+    const string &path,
+    const string &asset_id,
+    const string &exchange_id,
+    const string &broker_id,
+    size_t warmup)
+{
+    auto extension = filesystem::path(path).extension().string();
+    if (extension == ".argus")
+    {
+        return read_asset_file(path, asset_id, exchange_id, broker_id, warmup);
+    }
+    if (extension == ".csv")
+    {
+        return read_csv_file(path, asset_id, exchange_id, broker_id, warmup);
+    }
+    if (extension == ".feather" || extension == ".arrow")
+    {
+        return read_feather_file(path, asset_id, exchange_id, broker_id, warmup);
+    }
+    ARGUS_RUNTIME_ERROR(fmt::format("unsupported asset file extension: {}", path));
+}
@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "fmt/core.h"
+
+#include "asset.h"
+#include "asset_file.h"
+#include "asset_stream.h"
+#include "settings.h"
+
+using namespace std;
+
+AssetStream::AssetStream(const string &path, size_t chunk_rows_, size_t lookback_)
+    : chunk_rows(chunk_rows_), lookback(lookback_)
+{
+    if (this->chunk_rows == 0)
+    {
+        ARGUS_RUNTIME_ERROR("asset stream chunk size must be greater than 0");
+    }
+
+    this->file = make_shared<MappedFile>(path);
+    this->header = read_asset_file_header(*this->file, path, this->column_names);
+
+    // the index is binary searched and read by the exchange, the data block is never touched through the mapping
+    this->file->advise(this->header.index_offset, this->header.rows * sizeof(long long), MADV_WILLNEED);
+    this->file->advise(this->header.data_offset, this->header.rows * this->header.cols * sizeof(double), MADV_RANDOM);
+
+    this->fd = ::open(path.c_str(), O_RDONLY);
+    if (this->fd == -1)
+    {
+        ARGUS_RUNTIME_ERROR(fmt::format("failed to open file {}: {}", path, strerror(errno)));
+    }
+
+    this->window.resize(this->get_window_capacity() * this->header.cols);
+    this->chunk.resize(this->chunk_rows * this->header.cols);
+}
+
+AssetStream::~AssetStream()
+{
+    if (this->pending.valid())
+    {
+        this->pending.wait();
+    }
+    if (this->fd != -1)
+    {
+        ::close(this->fd);
+    }
+}
+
+long long const *AssetStream::get_datetime_index() const
+{
+    return reinterpret_cast<long long const *>(this->file->get_data() + this->header.index_offset);
+}
+
+void AssetStream::read(size_t start, size_t count, double *out, size_t column_stride) const
+{
+    // each column of the file is a contiguous block of rows doubles
+    for (size_t j = 0; j < this->header.cols; j++)
+    {
+        auto destination = reinterpret_cast<char *>(out + j * column_stride);
+        auto offset = static_cast<off_t>(this->header.data_offset + (j * this->header.rows + start) * sizeof(double));
+        size_t remaining = count * sizeof(double);
+        while (remaining)
+        {
+            auto bytes = pread(this->fd, destination, remaining, offset);
+            if (bytes <= 0)
+            {
+                if (bytes == -1 && errno == EINTR)
+                {
+                    continue;
+                }
+                ARGUS_RUNTIME_ERROR(fmt::format("failed to read asset stream: {}", strerror(errno)));
+            }
+            destination += bytes;
+            offset += bytes;
+            remaining -= static_cast<size_t>(bytes);
+        }
+    }
+}
+
+void AssetStream::wait()
+{
+    if (this->pending.valid())
+    {
+        // rethrows any error of the background read
+        this->pending.get();
+    }
+}
+
+void AssetStream::prefetch(size_t start)
+{
+    this->wait();
+    this->chunk_start = start;
+    this->chunk_count = start < this->header.rows ? std::min(this->chunk_rows, this->header.rows - start) : 0;
+    if (this->chunk_count)
+    {
+        this->pending = std::async(std::launch::async, [this, start]()
+        {
+            this->read(start, this->chunk_count, this->chunk.data(), this->chunk_rows);
+        });
+    }
+}
+
+void AssetStream::seek(size_t row_index)
+{
+    this->wait();
+
+    // read the rows before the target directly into the window
+    this->window_start = row_index > this->lookback ? row_index - this->lookback : 0;
+    this->window_rows = std::min(this->get_window_capacity(), this->header.rows - this->window_start);
+    this->read(this->window_start, this->window_rows, this->window.data(), this->get_window_capacity());
+
+    this->prefetch(this->get_window_end());
+}
+
+void AssetStream::advance()
+{
+    auto window_end = this->get_window_end();
+    if (window_end == this->header.rows)
+    {
+        return;
+    }
+
+    // the prefetch always targets the end of the window, read it now if the window was moved since
+    if (this->chunk_start != window_end)
+    {
+        this->prefetch(window_end);
+    }
+    this->wait();
+
+    // slide the last lookback rows to the front of each column and append the chunk after them
+    auto capacity = this->get_window_capacity();
+    auto keep = std::min(this->lookback, this->window_rows);
+    for (size_t j = 0; j < this->header.cols; j++)
+    {
+        auto column = this->window.data() + j * capacity;
+        std::memmove(column, column + this->window_rows - keep, keep * sizeof(double));
+        std::memcpy(column + keep, this->chunk.data() + j * this->chunk_rows, this->chunk_count * sizeof(double));
+    }
+    this->window_start = window_end - keep;
+    this->window_rows = keep + this->chunk_count;
+
+    this->prefetch(this->get_window_end());
+}
+
+shared_ptr<Asset> open_asset_stream(
+    const string &path,
+    const string &asset_id,
+    const string &exchange_id,
+    const string &broker_id,
+    size_t warmup,
+    size_t chunk_rows,
+    size_t lookback)
+{
+    auto stream = make_shared<AssetStream>(path, chunk_rows, lookback);
+    auto asset = make_shared<Asset>(asset_id, exchange_id, broker_id, warmup);
+    asset->load_headers(stream->get_column_names());
+    asset->load_stream(std::move(stream));
+    return asset;
+}
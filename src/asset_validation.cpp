@@ -0,0 +1,162 @@
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "fmt/core.h"
+
+#include "asset_validation.h"
+
+using namespace std;
+
+// The counting loops below are branch free integer reductions so the compiler vectorizes them with 
+// the baseline instruction set (sse2 has no 64 bit integer or double-to-count compares, so the checks 
+// are written as subtractions and sign bit shifts). The first bad row is only searched for once a 
+// check is known to have failed.
+
+/// bits of the largest finite double minus one, see invalid_price
+static constexpr uint64_t MAX_PRICE_BITS = 0x7FEFFFFFFFFFFFFEull;
+
+/// 1 if a price is nan, inf, zero or negative, 0 otherwise
+static inline uint64_t invalid_price(double value)
+{
+    // the bits of positive finite doubles are exactly 1 ..= 0x7FEFFFFFFFFFFFFF, after subtracting
+    // one a valid price has neither its sign bit set nor is greater than MAX_PRICE_BITS
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    bits -= 1;
+    return ((MAX_PRICE_BITS - bits) | bits) >> 63;
+}
+
+/// 1 if the difference between two timestamps is negative, 0 otherwise
+static inline uint64_t is_negative(uint64_t difference)
+{
+    return difference >> 63;
+}
+
+/// 1 if the difference between two timestamps is zero, 0 otherwise
+static inline uint64_t is_zero(uint64_t difference)
+{
+    return 1 - ((difference | (0 - difference)) >> 63);
+}
+
+bool AssetValidationReport::is_valid() const
+{
+    return this->unsorted.passed()
+        && this->duplicates.passed()
+        && this->invalid_open.passed()
+        && this->invalid_close.passed();
+}
+
+string AssetValidationReport::to_string() const
+{
+    if (!this->is_checked)
+    {
+        return fmt::format("asset {}: not validated", this->asset_id);
+    }
+    if (this->is_valid())
+    {
+        return fmt::format("asset {}: valid ({} rows)", this->asset_id, this->rows);
+    }
+
+    string summary = fmt::format("asset {}: invalid ({} rows)", this->asset_id, this->rows);
+    auto append = [&summary](const char *name, const ValidationCheck &check)
+    {
+        if (!check.passed())
+        {
+            summary += fmt::format(", {} {} rows (first at row {})", check.count, name, check.first_row);
+        }
+    };
+    append("unsorted", this->unsorted);
+    append("duplicate", this->duplicates);
+    append("invalid open", this->invalid_open);
+    append("invalid close", this->invalid_close);
+    return summary;
+}
+
+void AssetValidationReport::merge(const AssetValidationReport &appended, size_t row_offset)
+{
+    auto merge_check = [row_offset](ValidationCheck &check, const ValidationCheck &appended_check)
+    {
+        if (check.passed() && !appended_check.passed())
+        {
+            check.first_row = appended_check.first_row + row_offset;
+        }
+        check.count += appended_check.count;
+    };
+    merge_check(this->unsorted, appended.unsorted);
+    merge_check(this->duplicates, appended.duplicates);
+    merge_check(this->invalid_open, appended.invalid_open);
+    merge_check(this->invalid_close, appended.invalid_close);
+    this->rows += appended.rows;
+}
+
+void validate_datetime_index(long long const *datetime_index, size_t rows, AssetValidationReport &report)
+{
+    size_t unsorted = 0;
+    size_t duplicates = 0;
+    for (size_t i = 1; i < rows; i++)
+    {
+        auto difference = static_cast<uint64_t>(datetime_index[i]) - static_cast<uint64_t>(datetime_index[i - 1]);
+        unsorted += is_negative(difference);
+        duplicates += is_zero(difference);
+    }
+
+    report.unsorted.count = unsorted;
+    report.duplicates.count = duplicates;
+    if (unsorted)
+    {
+        for (size_t i = 1; i < rows; i++)
+        {
+            if (datetime_index[i] < datetime_index[i - 1])
+            {
+                report.unsorted.first_row = i;
+                break;
+            }
+        }
+    }
+    if (duplicates)
+    {
+        for (size_t i = 1; i < rows; i++)
+        {
+            if (datetime_index[i] == datetime_index[i - 1])
+            {
+                report.duplicates.first_row = i;
+                break;
+            }
+        }
+    }
+}
+
+void validate_prices(const double *values, size_t rows, size_t stride, ValidationCheck &check)
+{
+    size_t invalid = 0;
+    if (stride == 1)
+    {
+        for (size_t i = 0; i < rows; i++)
+        {
+            invalid += invalid_price(values[i]);
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < rows; i++)
+        {
+            invalid += invalid_price(values[i * stride]);
+        }
+    }
+
+    check.count = invalid;
+    if (invalid)
+    {
+        for (size_t i = 0; i < rows; i++)
+        {
+            if (invalid_price(values[i * stride]))
+            {
+                check.first_row = i;
+                break;
+            }
+        }
+    }
+}
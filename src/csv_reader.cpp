@@ -0,0 +1,506 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/mman.h>
+
+#include "fmt/core.h"
+
+#include "asset.h"
+#include "asset_file.h"
+#include "csv_reader.h"
+#include "datetime_index.h"
+#include "settings.h"
+#include "utils_string.h"
+#include "utils_thread.h"
+#include "utils_time.h"
+
+using namespace std;
+
+/// smallest chunk of the file handed to a single parsing thread
+static constexpr size_t CSV_MIN_CHUNK_SIZE = 1 << 20;
+
+/// powers of ten that are exactly representable as a double
+static constexpr double EXACT_POWERS_OF_TEN[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+/// buffers a csv asset views, owned by the asset through its data owner
+struct CsvAssetBuffers
+{
+    vector<double> data;
+};
+
+static inline bool is_digit(char c)
+{
+    return static_cast<unsigned char>(c - '0') < 10;
+}
+
+static inline bool is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static inline void trim(const char *&begin, const char *&end)
+{
+    while (begin < end && is_space(*begin))
+    {
+        begin++;
+    }
+    while (end > begin && is_space(end[-1]))
+    {
+        end--;
+    }
+}
+
+/// trim a field and strip one pair of surrounding double quotes
+static inline void unquote(const char *&begin, const char *&end)
+{
+    trim(begin, end);
+    if (end - begin >= 2 && *begin == '"' && end[-1] == '"')
+    {
+        begin++;
+        end--;
+    }
+}
+
+/// find the next occurrence of c in [begin, end), end if there is none
+static inline const char *find_char(const char *begin, const char *end, char c)
+{
+    auto found = static_cast<const char *>(memchr(begin, c, end - begin));
+    return found ? found : end;
+}
+
+/// does a line only contain whitespace
+static inline bool is_blank_line(const char *begin, const char *end)
+{
+    trim(begin, end);
+    return begin == end;
+}
+
+/// parse exactly n digits, returns false if any character is not a digit
+static inline bool parse_digits(const char *&p, const char *end, int n, int &value)
+{
+    if (end - p < n)
+    {
+        return false;
+    }
+    value = 0;
+    for (int i = 0; i < n; i++, p++)
+    {
+        if (!is_digit(*p))
+        {
+            return false;
+        }
+        value = value * 10 + (*p - '0');
+    }
+    return true;
+}
+
+/// number of days since 1970-01-01 of a civil date (proleptic gregorian calendar)
+static inline long long days_from_civil(long long y, unsigned m, unsigned d)
+{
+    y -= m <= 2;
+    const long long era = (y >= 0 ? y : y - 399) / 400;
+    const auto yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<long long>(doe) - 719468;
+}
+
+/// slow but exact fallback for numbers the fast path can't handle (nan, inf, long mantissas)
+static bool parse_double_fallback(const char *begin, const char *end, double &value)
+{
+    string field(begin, end);
+    char *parse_end = nullptr;
+    value = strtod(field.c_str(), &parse_end);
+    return parse_end == field.c_str() + field.size();
+}
+
+bool parse_double(const char *begin, const char *end, double &value)
+{
+    trim(begin, end);
+    if (begin == end)
+    {
+        value = NAN;
+        return true;
+    }
+
+    auto p = begin;
+    bool negative = false;
+    if (*p == '-' || *p == '+')
+    {
+        negative = *p == '-';
+        p++;
+    }
+
+    // accumulate up to 19 significant digits into an integer mantissa
+    uint64_t mantissa = 0;
+    int significant_digits = 0;
+    int exponent = 0;
+    bool has_digits = false;
+    bool truncated = false;
+    for (; p < end && is_digit(*p); p++)
+    {
+        has_digits = true;
+        if (significant_digits < 19)
+        {
+            mantissa = mantissa * 10 + (*p - '0');
+            significant_digits += mantissa != 0;
+        }
+        else
+        {
+            exponent++;
+            truncated = true;
+        }
+    }
+    if (p < end && *p == '.')
+    {
+        p++;
+        for (; p < end && is_digit(*p); p++)
+        {
+            has_digits = true;
+            if (significant_digits < 19)
+            {
+                mantissa = mantissa * 10 + (*p - '0');
+                significant_digits += mantissa != 0;
+                exponent--;
+            }
+            else
+            {
+                truncated = true;
+            }
+        }
+    }
+    if (has_digits && p < end && (*p == 'e' || *p == 'E'))
+    {
+        p++;
+        bool negative_exponent = false;
+        if (p < end && (*p == '-' || *p == '+'))
+        {
+            negative_exponent = *p == '-';
+            p++;
+        }
+        if (p == end || !is_digit(*p))
+        {
+            return false;
+        }
+        int explicit_exponent = 0;
+        for (; p < end && is_digit(*p); p++)
+        {
+            if (explicit_exponent < 100000)
+            {
+                explicit_exponent = explicit_exponent * 10 + (*p - '0');
+            }
+        }
+        exponent += negative_exponent ? -explicit_exponent : explicit_exponent;
+    }
+
+    // exact fast path: the mantissa and the power of ten are both exact doubles, so a single
+    // multiplication or division is correctly rounded
+    if (has_digits && p == end && !truncated
+        && mantissa <= (uint64_t(1) << 53) && exponent >= -22 && exponent <= 22)
+    {
+        auto result = static_cast<double>(mantissa);
+        result = exponent < 0 ? result / EXACT_POWERS_OF_TEN[-exponent] : result * EXACT_POWERS_OF_TEN[exponent];
+        value = negative ? -result : result;
+        return true;
+    }
+    return parse_double_fallback(begin, end, value);
+}
+
+bool parse_datetime(const char *begin, const char *end, long long epoch_scale, long long &value)
+{
+    trim(begin, end);
+    if (begin == end)
+    {
+        return false;
+    }
+
+    // integer epoch timestamp
+    auto p = begin;
+    bool negative = *p == '-';
+    if (negative || *p == '+')
+    {
+        p++;
+    }
+    auto digits_start = p;
+    long long epoch = 0;
+    for (; p < end && is_digit(*p); p++)
+    {
+        epoch = epoch * 10 + (*p - '0');
+    }
+    if (p == end && p != digits_start)
+    {
+        value = (negative ? -epoch : epoch) * epoch_scale;
+        return true;
+    }
+
+    // ISO-8601 date, YYYY-MM-DD
+    p = begin;
+    int year, month, day;
+    if (!parse_digits(p, end, 4, year) || p == end || *p++ != '-'
+        || !parse_digits(p, end, 2, month) || p == end || *p++ != '-'
+        || !parse_digits(p, end, 2, day))
+    {
+        return false;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > 31)
+    {
+        return false;
+    }
+
+    long long nanoseconds = 0;
+    if (p < end && (*p == 'T' || *p == ' '))
+    {
+        // time of day, HH:MM[:SS[.fffffffff]]
+        p++;
+        int hour, minute, second = 0;
+        if (!parse_digits(p, end, 2, hour) || p == end || *p++ != ':' || !parse_digits(p, end, 2, minute))
+        {
+            return false;
+        }
+        if (p < end && *p == ':')
+        {
+            p++;
+            if (!parse_digits(p, end, 2, second))
+            {
+                return false;
+            }
+            if (p < end && *p == '.')
+            {
+                p++;
+                long long fraction = 0;
+                int fraction_digits = 0;
+                for (; p < end && is_digit(*p); p++)
+                {
+                    if (fraction_digits < 9)
+                    {
+                        fraction = fraction * 10 + (*p - '0');
+                        fraction_digits++;
+                    }
+                }
+                for (; fraction_digits < 9; fraction_digits++)
+                {
+                    fraction *= 10;
+                }
+                nanoseconds += fraction;
+            }
+        }
+        if (hour > 23 || minute > 59 || second > 60)
+        {
+            return false;
+        }
+        nanoseconds += (hour * 3600LL + minute * 60LL + second) * 1000000000LL;
+
+        // utc offset, Z or (+|-)HH[:]MM
+        if (p < end && *p == 'Z')
+        {
+            p++;
+        }
+        else if (p < end && (*p == '+' || *p == '-'))
+        {
+            int sign = *p++ == '+' ? 1 : -1;
+            int offset_hour, offset_minute = 0;
+            if (!parse_digits(p, end, 2, offset_hour))
+            {
+                return false;
+            }
+            if (p < end && *p == ':')
+            {
+                p++;
+            }
+            if (p < end && !parse_digits(p, end, 2, offset_minute))
+            {
+                return false;
+            }
+            nanoseconds -= sign * (offset_hour * 3600LL + offset_minute * 60LL) * 1000000000LL;
+        }
+    }
+    if (p != end)
+    {
+        return false;
+    }
+
+    value = days_from_civil(year, month, day) * 86400LL * 1000000000LL + nanoseconds;
+    return true;
+}
+
+/// split a line into trimmed, unquoted fields
+static vector<string> split_fields(const char *begin, const char *end, char delimiter)
+{
+    vector<string> fields;
+    while (true)
+    {
+        auto field_end = find_char(begin, end, delimiter);
+        auto field_begin = begin;
+        auto field_stop = field_end;
+        unquote(field_begin, field_stop);
+        fields.emplace_back(field_begin, field_stop);
+        if (field_end == end)
+        {
+            return fields;
+        }
+        begin = field_end + 1;
+    }
+}
+
+shared_ptr<Asset> read_csv_file(
+    const string &path,
+    const string &asset_id,
+    const string &exchange_id,
+    const string &broker_id,
+    size_t warmup,
+    const string &datetime_column,
+    const string &epoch_unit,
+    char delimiter,
+    size_t threads)
+{
+    auto epoch_scale = epoch_unit_scale(epoch_unit);
+
+    MappedFile file(path);
+    auto file_begin = file.get_data();
+    auto file_end = file_begin + file.get_size();
+    file.advise(0, file.get_size(), MADV_SEQUENTIAL);
+
+    // skip a utf-8 byte order mark
+    if (file.get_size() >= 3 && memcmp(file_begin, "\xEF\xBB\xBF", 3) == 0)
+    {
+        file_begin += 3;
+    }
+
+    // parse the header line, every column other than the datetime column is a data column
+    auto header_end = find_char(file_begin, file_end, '\n');
+    auto fields = split_fields(file_begin, header_end, delimiter);
+    auto field_count = fields.size();
+    size_t datetime_position = datetime_column.empty() ? 0 : case_ins_str_index(fields, datetime_column);
+
+    vector<string> column_names;
+    for (size_t i = 0; i < field_count; i++)
+    {
+        if (i != datetime_position)
+        {
+            column_names.push_back(fields[i]);
+        }
+    }
+    if (column_names.empty())
+    {
+        ARGUS_RUNTIME_ERROR(fmt::format("csv file has no data columns: {}", path));
+    }
+    auto cols = column_names.size();
+
+    // split the body into chunks that start at the beginning of a line
+    auto body_begin = header_end == file_end ? file_end : header_end + 1;
+    auto body_size = static_cast<size_t>(file_end - body_begin);
+    auto chunk_count = resolve_thread_count(threads, std::max<size_t>(1, body_size / CSV_MIN_CHUNK_SIZE));
+    vector<const char *> chunk_bounds{body_begin};
+    for (size_t k = 1; k < chunk_count; k++)
+    {
+        auto bound = find_char(std::max(body_begin + k * body_size / chunk_count, chunk_bounds.back()), file_end, '\n');
+        chunk_bounds.push_back(bound == file_end ? file_end : bound + 1);
+    }
+    chunk_bounds.push_back(file_end);
+
+    // first pass, count the rows in each chunk so every chunk knows where its rows go
+    vector<size_t> chunk_rows(chunk_count + 1, 0);
+    parallel_for(chunk_count, threads, [&](size_t k)
+    {
+        size_t count = 0;
+        for (auto line = chunk_bounds[k]; line < chunk_bounds[k + 1];)
+        {
+            auto line_end = find_char(line, chunk_bounds[k + 1], '\n');
+            count += !is_blank_line(line, line_end);
+            if (line_end == chunk_bounds[k + 1])
+            {
+                break;
+            }
+            line = line_end + 1;
+        }
+        chunk_rows[k + 1] = count;
+    });
+    for (size_t k = 1; k <= chunk_count; k++)
+    {
+        chunk_rows[k] += chunk_rows[k - 1];
+    }
+    auto rows = chunk_rows[chunk_count];
+    if (rows == 0)
+    {
+        ARGUS_RUNTIME_ERROR(fmt::format("csv file has no rows: {}", path));
+    }
+
+    // second pass, parse each chunk straight into the column-major buffers
+    auto buffers = make_shared<CsvAssetBuffers>();
+    buffers->data.resize(rows * cols);
+    vector<long long> parsed_index(rows);
+    auto data = buffers->data.data();
+    auto datetime_index = parsed_index.data();
+
+    // parse the fields of a single line into the given row
+    auto parse_line = [&](const char *line, const char *line_end, size_t row)
+    {
+        auto field = line;
+        size_t column = 0;
+        for (size_t i = 0; i < field_count; i++)
+        {
+            auto field_end = i + 1 < field_count ? find_char(field, line_end, delimiter) : line_end;
+            if (field_end == line_end && i + 1 < field_count)
+            {
+                ARGUS_RUNTIME_ERROR(fmt::format("{}: row {} has too few columns", path, row));
+            }
+
+            // quoted fields are parsed like the header, without their quotes
+            auto value_begin = field;
+            auto value_end = field_end;
+            unquote(value_begin, value_end);
+
+            bool parsed;
+            if (i == datetime_position)
+            {
+                parsed = parse_datetime(value_begin, value_end, epoch_scale, datetime_index[row]);
+            }
+            else
+            {
+                parsed = parse_double(value_begin, value_end, data[column * rows + row]);
+                column++;
+            }
+            if (!parsed)
+            {
+                ARGUS_RUNTIME_ERROR(fmt::format(
+                    "{}: failed to parse row {} column {}: {}",
+                    path, row, fields[i], string(field, field_end)));
+            }
+            field = field_end + 1;
+        }
+    };
+
+    parallel_for(chunk_count, threads, [&](size_t k)
+    {
+        auto row = chunk_rows[k];
+        for (auto line = chunk_bounds[k]; line < chunk_bounds[k + 1];)
+        {
+            auto line_end = find_char(line, chunk_bounds[k + 1], '\n');
+            if (!is_blank_line(line, line_end))
+            {
+                parse_line(line, line_end, row);
+                row++;
+            }
+            if (line_end == chunk_bounds[k + 1])
+            {
+                break;
+            }
+            line = line_end + 1;
+        }
+    });
+
+    // share the datetime index with any other asset that has the same one
+    auto shared_index = intern_datetime_index(std::move(parsed_index));
+
+    auto asset = make_shared<Asset>(asset_id, exchange_id, broker_id, warmup);
+    asset->load_headers(column_names);
+    asset->load_view(data, shared_index, rows, cols, true, std::move(buffers));
+    return asset;
+}
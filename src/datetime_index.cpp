@@ -0,0 +1,223 @@
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "datetime_index.h"
+#include "intern_pool.h"
+
+using namespace std;
+
+/// datetime indexes alive, shared by every asset, exchange and hydra with the same index
+static InternPool<DatetimeIndex> datetime_index_pool;
+
+DatetimeIndex::DatetimeIndex(vector<long long> values_) : size(values_.size()), values(std::move(values_))
+{
+    this->hash = hash_datetime_index(this->values.data(), this->size);
+    this->detect_runs();
+
+    // the runs describe a regular index completely, the values are dropped until someone asks for them
+    if (!this->runs.empty())
+    {
+        vector<long long>().swap(this->values);
+    }
+}
+
+long long const *DatetimeIndex::get_data() const
+{
+    if (!this->runs.empty())
+    {
+        std::call_once(this->expand_flag, [this]() {
+            this->values.resize(this->size);
+            this->copy_values(0, this->size, this->values.data());
+        });
+    }
+    return this->values.data();
+}
+
+vector<IndexRun>::const_iterator DatetimeIndex::find_run(size_t row) const
+{
+    auto run = std::upper_bound(this->runs.begin(), this->runs.end(), row, 
+        [](size_t r, const IndexRun &index_run) { return r < index_run.first_row; });
+    return run - 1;
+}
+
+long long DatetimeIndex::at(size_t row) const
+{
+    if (this->runs.empty())
+    {
+        return this->values[row];
+    }
+    auto run = this->runs.size() == 1 ? this->runs.begin() : this->find_run(row);
+    return run->start + static_cast<long long>(row - run->first_row) * this->step;
+}
+
+void DatetimeIndex::copy_values(size_t first, size_t count, long long *out) const
+{
+    if (this->runs.empty())
+    {
+        std::copy(this->values.begin() + first, this->values.begin() + first + count, out);
+        return;
+    }
+
+    // fill run by run, each row is one step after the row before it within a run
+    auto run = this->find_run(first);
+    for (size_t row = first; row < first + count; row++)
+    {
+        if (run + 1 != this->runs.end() && row == (run + 1)->first_row)
+        {
+            ++run;
+        }
+        *out++ = run->start + static_cast<long long>(row - run->first_row) * this->step;
+    }
+}
+
+bool DatetimeIndex::matches(size_t first, long long const *values_, size_t count) const
+{
+    if (first + count > this->size)
+    {
+        return false;
+    }
+    if (this->runs.empty())
+    {
+        return std::equal(values_, values_ + count, this->values.begin() + first);
+    }
+
+    auto run = this->find_run(first);
+    for (size_t row = first; row < first + count; row++)
+    {
+        if (run + 1 != this->runs.end() && row == (run + 1)->first_row)
+        {
+            ++run;
+        }
+        if (*values_++ != run->start + static_cast<long long>(row - run->first_row) * this->step)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void DatetimeIndex::detect_runs()
+{
+    auto size = this->values.size();
+    if (size < 2)
+    {
+        return;
+    }
+
+    // the step is the smallest gap, unsorted or duplicate time stamps can't be regular
+    long long step_ = LLONG_MAX;
+    for (size_t i = 1; i < size; i++)
+    {
+        auto gap = this->values[i] - this->values[i - 1];
+        if (gap <= 0)
+        {
+            return;
+        }
+        step_ = std::min(step_, gap);
+    }
+
+    // every gap larger than the step starts a new run, too many runs and binary search is as fast
+    vector<IndexRun> runs_ = {{this->values[0], 0}};
+    auto max_runs = std::max<size_t>(1, size / REGULAR_INDEX_MIN_RUN_LENGTH);
+    for (size_t i = 1; i < size; i++)
+    {
+        if (this->values[i] - this->values[i - 1] == step_)
+        {
+            continue;
+        }
+        if (runs_.size() == max_runs)
+        {
+            return;
+        }
+        runs_.push_back({this->values[i], i});
+    }
+    runs_.shrink_to_fit();
+    this->step = step_;
+    this->runs = std::move(runs_);
+}
+
+size_t DatetimeIndex::lower_bound(long long datetime, size_t first) const
+{
+    auto size = this->size;
+    if (first >= size)
+    {
+        return size;
+    }
+    if (this->runs.empty())
+    {
+        return std::lower_bound(this->values.begin() + first, this->values.end(), datetime) - this->values.begin();
+    }
+
+    // last run starting at or before the datetime, the datetime is before the index if there is none
+    auto run = std::upper_bound(this->runs.begin(), this->runs.end(), datetime, 
+        [](long long t, const IndexRun &r) { return t < r.start; });
+    if (run == this->runs.begin())
+    {
+        return first;
+    }
+    auto run_end = run == this->runs.end() ? size : run->first_row;
+    --run;
+
+    // whole steps from the start of the run rounded up, past the end of the run is the next run's first row
+    auto distance = static_cast<uint64_t>(datetime) - static_cast<uint64_t>(run->start);
+    auto steps = distance / this->step + (distance % this->step != 0);
+    size_t row = steps < run_end - run->first_row ? run->first_row + static_cast<size_t>(steps) : run_end;
+    return std::max(row, first);
+}
+
+bool DatetimeIndex::is_contiguous(size_t first, size_t count) const
+{
+    if (this->runs.empty() || first + count > this->size)
+    {
+        return false;
+    }
+
+    // end of the run containing the first row
+    auto run = this->find_run(first) + 1;
+    auto run_end = run == this->runs.end() ? this->size : run->first_row;
+    return first + count <= run_end;
+}
+
+size_t hash_datetime_index(long long const *values, size_t length)
+{
+    // FNV-1a over the values, seeded with the length
+    uint64_t hash = 14695981039346656037ULL ^ length;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= static_cast<uint64_t>(values[i]);
+        hash *= 1099511628211ULL;
+    }
+    return static_cast<size_t>(hash);
+}
+
+/// does an interned index hold exactly the values
+static bool index_equals(const DatetimeIndex &index, long long const *values, size_t length)
+{
+    return index.get_size() == length && index.matches(0, values, length);
+}
+
+datetime_index_sp_t intern_datetime_index(long long const *values, size_t length)
+{
+    return datetime_index_pool.intern(
+        hash_datetime_index(values, length),
+        [values, length](const DatetimeIndex &index) { return index_equals(index, values, length); },
+        [values, length]() { return new DatetimeIndex(vector<long long>(values, values + length)); });
+}
+
+datetime_index_sp_t intern_datetime_index(vector<long long> &&values)
+{
+    return datetime_index_pool.intern(
+        hash_datetime_index(values.data(), values.size()),
+        [&values](const DatetimeIndex &index) { return index_equals(index, values.data(), values.size()); },
+        [&values]() { return new DatetimeIndex(std::move(values)); });
+}
+
+size_t get_interned_datetime_index_count()
+{
+    return datetime_index_pool.size();
+}
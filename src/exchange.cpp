@@ -10,11 +10,14 @@
 #include <stdexcept>
 
 #include "fmt/core.h"
+#include "tsl/robin_set.h"
 #include "pybind11/pytypes.h"
 
 #include "exchange.h"
 #include "asset.h"
+#include "asset_file.h"
 #include "utils_array.h"
+#include "utils_thread.h"
 #include "settings.h"
 
 using namespace std;
@@ -26,7 +29,6 @@ Exchange::Exchange(std::string exchange_id_, int logging_) : exchange_id(std::mo
                                                              on_close(false),
                                                              logging(logging_)
 {
-    this->datetime_index = new long long[0];
     this->current_index = 0;
     this->datetime_index_length = 0;
     this->exchange_time = 0;
@@ -43,39 +45,94 @@ void Exchange::build()
     {
         throw std::runtime_error("no assets in the exchange to build");
     }
-    // check to see if the exchange has been built before
-    if (this->is_built)
-    {
-        delete[] this->datetime_index;
+    this->candles = 0;
+    this->arena_size = 0;
+
+    // lazy assets are loaded once to pin their datetime index and validate their data, 
+    // their data is released until needed
+    this->validation_reports.clear();
+    for(auto& asset_pair : this->market){
+        auto& asset = asset_pair.second;
+        auto is_first_load = asset->get_is_lazy() && !asset->get_is_built();
+        if(is_first_load){
+            asset->page_in();
+        }
+        if(is_first_load || !asset->get_validation_report().is_checked){
+            asset->validate();
+        }
+        if(is_first_load){
+            asset->page_out();
+        }
+
+        // bad data is reported instead of thrown so every asset is checked
+        auto& report = asset->get_validation_report();
+        if(!report.is_valid()){
+            this->validation_reports.push_back(report);
+            if(this->logging){
+                printf("EXCHANGE: %s\n", report.to_string().c_str());
+            }
+        }
     }
 
-    this->candles = 0;
+    // derived columns are evaluated column-wide over each asset's full history
+    if(!this->derived_columns.empty()){
+        vector<Asset*> assets;
+        for(auto& asset_pair : this->market){
+            auto& asset = asset_pair.second;
+            if(asset->get_is_lazy() || asset->get_is_stream()){
+                throw std::runtime_error(fmt::format(
+                    "derived columns are not supported for lazy or streaming asset {}", asset->get_asset_id()));
+            }
+            assets.push_back(asset.get());
+        }
+        parallel_for(assets.size(), 0, [&](size_t i)
+        {
+            add_derived_columns(*assets[i], this->derived_columns, this->feature_cache.get());
+        });
+    }
+
+    // interned schemas are equal if their pointers are, column ids are exchange wide if all match
+    this->schema = this->market.begin()->second->get_schema();
+    for(auto& asset_pair : this->market){
+        if(asset_pair.second->get_schema() != this->schema){
+            this->schema = nullptr;
+            break;
+        }
+    }
 
+    // regular asset indexes are stored as their runs, each distinct one is expanded for the merge only
+    tsl::robin_map<const DatetimeIndex *, vector<long long>> expanded;
+    for(auto& asset_pair : this->market){
+        auto index = asset_pair.second->get_interned_datetime_index();
+        if(index && index->is_regular() && !expanded.count(index)){
+            vector<long long> values(index->get_size());
+            index->copy_values(0, values.size(), values.data());
+            expanded.emplace(index, std::move(values));
+        }
+    }
     auto datetime_index_ = container_sorted_union(
         this->market,
-        [](const shared_ptr<Asset> &obj)
-        { return obj->get_datetime_index(true); },
+        [&expanded](const shared_ptr<Asset> &obj)
+        {
+            auto index = obj->get_interned_datetime_index();
+            auto it = index ? expanded.find(index) : expanded.end();
+            return it != expanded.end() ? it->second.data() + obj->warmup : obj->get_datetime_index(true);
+        },
         [](const shared_ptr<Asset> &obj)
         { return obj->get_rows() - obj->warmup; });
 
-    this->datetime_index = get<0>(datetime_index_);
-    this->datetime_index_length = get<1>(datetime_index_);
+    // share the index with the assets if the exchange is alligned with them
+    this->datetime_index_sp = intern_datetime_index(std::move(datetime_index_));
+    this->datetime_index = this->datetime_index_sp->get_data();
+    this->datetime_index_length = this->datetime_index_sp->get_size();
 
+    this->allign_assets();
+    this->build_activation_schedule();
+    this->indexed_rows.clear();
     for(auto& asset_pair : this->market){
         auto asset = asset_pair.second;
-        
-        // test to see if asset is alligned with the exchage's datetime index
-        // makes updating market view faster
-        if(asset->get_rows() == this->datetime_index_length){
-            asset->is_alligned = true;
-            this->market_view[asset->get_asset_id()] = asset.get();
-        }
-        else{
-            asset->is_alligned = false;
-        }
-
         this->candles+= asset->get_rows();
-
+        this->indexed_rows[asset_pair.first] = asset->get_rows();
     }
 
     this->is_built = true;
@@ -85,19 +142,251 @@ void Exchange::build()
 #endif
 }
 
+void Exchange::add_derived_column(const string &name, const string &expression)
+{
+    for(auto& derived_column : this->derived_columns){
+        if(derived_column.name == name){
+            throw std::runtime_error(fmt::format("derived column {} already exists", name));
+        }
+    }
+    this->derived_columns.push_back(DerivedColumn{name, Expression(expression)});
+}
+
+void Exchange::set_feature_cache(const string &dir_path)
+{
+    this->feature_cache = make_shared<FeatureCache>(dir_path);
+}
+
+void Exchange::build_activation_schedule()
+{
+    this->activation_schedule.clear();
+    auto add_asset = [this](Asset *asset)
+    {
+        if(asset->get_rows() <= asset->warmup){
+            return;
+        }
+        auto asset_rows = asset->get_rows() - asset->warmup;
+
+        // alligned assets stream every bar from their offset until they expire
+        if(asset->is_alligned){
+            this->activation_schedule.push_back({asset->exchange_offset, asset, true});
+            return;
+        }
+
+        // walk the asset's rows along the exchange index, a gap pauses the asset until its next row
+        auto position = this->datetime_index_sp->lower_bound(asset->get_datetime(asset->warmup));
+        this->activation_schedule.push_back({position, asset, true});
+        for(size_t i = 1; i < asset_rows; i++){
+            auto datetime = asset->get_datetime(asset->warmup + i);
+            if(position + 1 < this->datetime_index_length && this->datetime_index[position + 1] == datetime){
+                position++;
+                continue;
+            }
+            this->activation_schedule.push_back({position + 1, asset, false});
+            position = this->datetime_index_sp->lower_bound(datetime, position + 1);
+            this->activation_schedule.push_back({position, asset, true});
+        }
+    };
+
+    // expired assets are part of the schedule so they stream again after a reset
+    for(auto& asset_pair : this->market){
+        add_asset(asset_pair.second.get());
+    }
+    for(auto& asset : this->expired_assets){
+        if(!this->market.count(asset->get_asset_id())){
+            add_asset(asset.get());
+        }
+    }
+    std::stable_sort(this->activation_schedule.begin(), this->activation_schedule.end(), 
+        [](const ActivationEvent &a, const ActivationEvent &b) { return a.position < b.position; });
+    this->is_schedule_stale = true;
+}
+
+void Exchange::replay_activation_schedule()
+{
+    // state of every asset with an event before the current bar
+    tsl::robin_map<Asset *, bool> is_active;
+    this->schedule_index = 0;
+    while(this->schedule_index < this->activation_schedule.size() 
+        && this->activation_schedule[this->schedule_index].position < this->current_index){
+        auto& event = this->activation_schedule[this->schedule_index++];
+        is_active[event.asset] = event.is_activation;
+    }
+
+    this->active_assets.clear();
+    this->active_slots.assign(this->market_view.size(), NO_ACTIVE_SLOT);
+    for(auto& asset_pair : this->market){
+        auto asset = asset_pair.second.get();
+        auto it = is_active.find(asset);
+        if(it == is_active.end()){
+            this->market_view[asset->market_id] = starts_in_view(asset) ? asset : nullptr;
+            continue;
+        }
+        if(!it->second){
+            this->market_view[asset->market_id] = nullptr;
+            continue;
+        }
+        if(!asset->get_is_resident()){
+            asset->page_in();
+        }
+        this->market_view[asset->market_id] = asset;
+        if(!asset->is_last_view()){
+            this->active_slots[asset->market_id] = this->active_assets.size();
+            this->active_assets.push_back(asset);
+        }
+    }
+    this->is_schedule_stale = false;
+}
+
+void Exchange::allign_assets()
+{
+    // test to see if the asset's streamed rows are a contiguous slice of the exchange's datetime index,
+    // assets that list late or delist early are still alligned between their first and last row
+    auto allign_asset = [this](Asset *asset)
+    {
+        asset->is_alligned = false;
+        asset->exchange_offset = 0;
+        if(asset->get_rows() <= asset->warmup){
+            return;
+        }
+        auto asset_start = asset->get_datetime(asset->warmup);
+        auto asset_rows = asset->get_rows() - asset->warmup;
+        auto offset = this->datetime_index_sp->lower_bound(asset_start);
+        auto first = this->datetime_index + offset;
+        if(offset + asset_rows > this->datetime_index_length){
+            return;
+        }
+
+        // assets sharing the exchange's interned index don't need to be compared, neither do regular
+        // assets without gaps that start on a bar of a run of the exchange with the same step
+        auto interned_index = asset->get_interned_datetime_index();
+        auto is_regular_slice = interned_index 
+            && asset->warmup == 0
+            && interned_index->get_runs().size() == 1
+            && interned_index->get_step() == this->datetime_index_sp->get_step()
+            && *first == asset_start
+            && this->datetime_index_sp->is_contiguous(offset, asset_rows);
+        auto is_equal_slice = [&]()
+        {
+            if(interned_index){
+                return interned_index->matches(asset->warmup, first, asset_rows);
+            }
+            auto asset_index = asset->get_datetime_index(true);
+            return std::equal(asset_index, asset_index + asset_rows, first);
+        };
+        asset->is_alligned = interned_index == this->datetime_index_sp.get()
+            || is_regular_slice
+            || is_equal_slice();
+        asset->exchange_offset = asset->is_alligned ? offset : 0;
+    };
+
+    for(auto& asset_pair : this->market){
+        auto asset = asset_pair.second.get();
+        allign_asset(asset);
+
+        // lazy assets are paged in as they start streaming
+        if(starts_in_view(asset)){
+            this->market_view[asset->market_id] = asset;
+        }
+    }
+    for(auto& asset : this->expired_assets){
+        if(!this->market.count(asset->get_asset_id())){
+            allign_asset(asset.get());
+        }
+    }
+}
+
+vector<long long> Exchange::extend(long long streamed_until)
+{
+    if(!this->is_built){
+        throw std::runtime_error("exchange must be built before it is extended");
+    }
+
+    // assets that expired before rows were appended to them start streaming again
+    auto expired = std::move(this->expired_assets);
+    this->expired_assets.clear();
+    for(auto& asset : expired){
+        if(asset->is_last_view()){
+            this->expired_assets.push_back(asset);
+        }
+        else{
+            this->market.insert({asset->get_asset_id(), asset});
+        }
+    }
+
+    // collect the timestamps of the rows appended since the index was last built
+    vector<long long> appended;
+    for(auto& asset_pair : this->market){
+        auto& asset = asset_pair.second;
+        auto start = std::max(this->indexed_rows[asset_pair.first], asset->warmup);
+        auto rows = asset->get_rows();
+        auto first = std::min(start, rows);
+        auto appended_size = appended.size();
+        appended.resize(appended_size + rows - first);
+        asset->copy_datetime_index(first, rows - first, appended.data() + appended_size);
+    }
+    std::sort(appended.begin(), appended.end());
+    appended.erase(std::unique(appended.begin(), appended.end()), appended.end());
+
+    // an asset can't catch up to the exchange if it was given rows in the past
+    if(this->current_index){
+        streamed_until = std::max(streamed_until, this->datetime_index[this->current_index - 1]);
+    }
+    if(!appended.empty() && appended.front() <= streamed_until){
+        throw std::runtime_error("can't append rows before the last time the exchange has streamed");
+    }
+    for(auto& asset_pair : this->market){
+        auto& indexed = this->indexed_rows[asset_pair.first];
+
+        // appended rows get their derived columns computed over the rows before them
+        if(!this->derived_columns.empty() && asset_pair.second->get_rows() > indexed){
+            update_derived_columns(*asset_pair.second, this->derived_columns, indexed);
+        }
+        this->candles += asset_pair.second->get_rows() - indexed;
+        indexed = asset_pair.second->get_rows();
+    }
+
+    // only timestamps that are not in the index yet are added to it
+    vector<long long> added;
+    std::set_difference(
+        appended.begin(), appended.end(),
+        this->datetime_index, this->datetime_index + this->datetime_index_length,
+        std::back_inserter(added));
+    if(added.empty()){
+        this->allign_assets();
+        this->build_activation_schedule();
+        return added;
+    }
+
+    vector<long long> extended_index;
+    extended_index.reserve(this->datetime_index_length + added.size());
+    std::merge(
+        this->datetime_index, this->datetime_index + this->datetime_index_length,
+        added.begin(), added.end(),
+        std::back_inserter(extended_index));
+    this->datetime_index_sp = intern_datetime_index(std::move(extended_index));
+    this->datetime_index = this->datetime_index_sp->get_data();
+    this->datetime_index_length = this->datetime_index_sp->get_size();
+
+    this->allign_assets();
+    this->build_activation_schedule();
+    return added;
+}
+
 void Exchange::reset_exchange()
 {
     this->current_index = 0;
-    this->market_view.clear();
+    std::fill(this->market_view.begin(), this->market_view.end(), nullptr);
 
-    // reset assets still in the market
+    // reset assets still in the market, lazy assets are paged back in when they start streaming
     for(auto & asset_pair : this->market)
     {   
         auto asset_sp = asset_pair.second;
+        asset_sp->page_out();
         asset_sp->reset_asset();
-        if(asset_sp->is_alligned)
+        if(starts_in_view(asset_sp.get()))
         {
-            this->market_view[asset_sp->get_asset_id()] = asset_sp.get();
+            this->market_view[asset_sp->market_id] = asset_sp.get();
         }
     }
     // reset assets that were expired and bring them back in to view
@@ -105,22 +394,28 @@ void Exchange::reset_exchange()
     {   
         asset_sp->reset_asset();
         this->market.insert({asset_sp->get_asset_id(), asset_sp});
-        if(asset_sp->is_alligned)
+        if(starts_in_view(asset_sp.get()))
         {
-            this->market_view[asset_sp->get_asset_id()] = asset_sp.get();
+            this->market_view[asset_sp->market_id] = asset_sp.get();
         }
     }
     // reset market allignment
     for(auto & asset_pair : this->market)
     {   
         auto asset = asset_pair.second;
-        if(asset->is_alligned)
+        if(starts_in_view(asset.get()))
         {
-            this->market_view[asset->get_asset_id()] = asset.get();
+            this->market_view[asset->market_id] = asset.get();
         }
     }
     this->expired_assets.clear();
     this->open_orders.clear();
+
+    // every asset starts streaming again from the start of the schedule
+    this->active_assets.clear();
+    this->active_slots.clear();
+    this->schedule_index = 0;
+    this->is_schedule_stale = true;
 }
 
 Exchange::~Exchange()
@@ -129,7 +424,6 @@ Exchange::~Exchange()
     printf("MEMORY:   calling exchange %s DESTRUCTOR ON: %p \n", this->exchange_id.c_str(), this);
     printf("EXCHANGE: is built: %d", this->is_built);
 #endif
-    delete[] this->datetime_index;
 #ifdef DEBUGGING
     printf("MEMORY:   exchange %s DESTRUCTOR complete\n", this->exchange_id.c_str());
 #endif
@@ -155,11 +449,29 @@ shared_ptr<Asset> Exchange::new_asset(const string &asset_id_, const string &bro
         throw runtime_error("asset already exists");
     }
     auto asset = make_shared<Asset>(asset_id_, this->exchange_id, broker_id);
-    this->market.emplace(asset_id_, make_shared<Asset>(*asset));
-    this->market_view.emplace(asset_id_, nullptr);
+    auto listed_asset = make_shared<Asset>(*asset);
+    this->add_market_id(listed_asset.get());
+    asset->market_id = listed_asset->market_id;
+    this->market.emplace(asset_id_, listed_asset);
     return asset;
 }
 
+void Exchange::add_market_id(Asset *asset)
+{
+    asset->market_id = this->market_view.size();
+    this->market_ids.emplace(asset->get_asset_id(), asset->market_id);
+    this->market_view.push_back(nullptr);
+}
+
+size_t Exchange::resolve_market_id(Order &order)
+{
+    if(order.get_market_id() == ORDER_NO_MARKET_ID)
+    {
+        order.set_market_id(this->get_market_id(order.get_asset_id()));
+    }
+    return order.get_market_id();
+}
+
 void Exchange::register_asset(const shared_ptr<Asset> &asset_)
 {
     string asset_id = asset_->get_asset_id();
@@ -174,11 +486,101 @@ void Exchange::register_asset(const shared_ptr<Asset> &asset_)
     }
     else
     {
+        this->add_market_id(asset_.get());
         this->market.emplace(asset_id, asset_);
-        this->market_view.emplace(asset_id, nullptr);
     }
 }
 
+void Exchange::register_assets_from_files(
+    const vector<string> &paths, 
+    const string &broker_id, 
+    size_t warmup, 
+    size_t threads)
+{
+    // make sure no asset id is loaded twice before doing any work
+    vector<string> asset_ids;
+    asset_ids.reserve(paths.size());
+    tsl::robin_set<string> seen_ids;
+    seen_ids.reserve(paths.size());
+    for (const auto &path : paths)
+    {
+        auto asset_id = asset_id_from_path(path);
+        if (this->market.count(asset_id) || !seen_ids.insert(asset_id).second)
+        {
+            ARGUS_RUNTIME_ERROR(fmt::format("asset already exists: {}", asset_id));
+        }
+        asset_ids.push_back(asset_id);
+    }
+
+    // parse the files in parallel, each worker writes only its own slot
+    vector<asset_sp_t> assets(paths.size());
+    parallel_for(paths.size(), threads, [&](size_t i)
+    {
+        assets[i] = load_asset_file(paths[i], asset_ids[i], this->exchange_id, broker_id, warmup);
+    });
+
+    // registering touches the market containers so it stays on the calling thread
+    for (const auto &asset : assets)
+    {
+        this->register_asset(asset);
+    }
+}
+
+void Exchange::register_assets_from_dir(
+    const string &dir_path, 
+    const string &broker_id, 
+    size_t warmup, 
+    size_t threads)
+{
+    auto paths = list_asset_files(dir_path);
+    if (paths.empty())
+    {
+        ARGUS_RUNTIME_ERROR(fmt::format("no asset files found in: {}", dir_path));
+    }
+    this->register_assets_from_files(paths, broker_id, warmup, threads);
+}
+
+void Exchange::register_lazy_asset(
+    const string &asset_id, 
+    const string &broker_id, 
+    Asset::asset_loader_t loader)
+{
+    auto asset = make_shared<Asset>(asset_id, this->exchange_id, broker_id);
+    asset->set_loader(std::move(loader));
+    this->register_asset(asset);
+}
+
+void Exchange::register_lazy_assets_from_files(
+    const vector<string> &paths, 
+    const string &broker_id, 
+    size_t warmup)
+{
+    for (const auto &path : paths)
+    {
+        auto asset_id = asset_id_from_path(path);
+        auto exchange_id = this->exchange_id;
+        auto asset = make_shared<Asset>(asset_id, exchange_id, broker_id, warmup);
+        asset->set_loader([=]()
+        {
+            return load_asset_file(path, asset_id, exchange_id, broker_id, warmup);
+        });
+        this->register_asset(asset);
+    }
+}
+
+void Exchange::register_lazy_assets_from_dir(
+    const string &dir_path, 
+    const string &broker_id, 
+    size_t warmup)
+{
+    auto paths = list_asset_files(dir_path);
+    if (paths.empty())
+    {
+        ARGUS_RUNTIME_ERROR(fmt::format("no asset files found in: {}", dir_path));
+    }
+    this->register_lazy_assets_from_files(paths, broker_id, warmup);
+}
+
 py::array_t<long long> Exchange::get_datetime_index_view()
 {
     if (!this->is_built)
@@ -202,7 +604,7 @@ void Exchange::place_order(shared_ptr<Order> &order_)
 
 void Exchange::process_market_order(shared_ptr<Order> &open_order)
 {
-    auto market_price = this->get_market_price(open_order->get_asset_id());
+    auto market_price = this->get_market_price(open_order->get_market_id());
     if (market_price == 0)
     {
         ARGUS_RUNTIME_ERROR("received order for which asset is not currently streaming");
@@ -212,7 +614,7 @@ void Exchange::process_market_order(shared_ptr<Order> &open_order)
 
 void Exchange::process_limit_order(shared_ptr<Order> &open_order)
 {
-    auto market_price = this->get_market_price(open_order->get_asset_id()); 
+    auto market_price = this->get_market_price(open_order->get_market_id()); 
     if (market_price == 0)
     {
         ARGUS_RUNTIME_ERROR("received order for which asset is not currently streaming");
@@ -229,7 +631,7 @@ void Exchange::process_limit_order(shared_ptr<Order> &open_order)
 
 void Exchange::process_stop_loss_order(shared_ptr<Order> &open_order)
 {
-    auto market_price = this->get_market_price(open_order->get_asset_id());
+    auto market_price = this->get_market_price(open_order->get_market_id());
     if (market_price == 0)
     {
         ARGUS_RUNTIME_ERROR("received order for which asset is not currently streaming");
@@ -246,7 +648,7 @@ void Exchange::process_stop_loss_order(shared_ptr<Order> &open_order)
 
 void Exchange::process_take_profit_order(shared_ptr<Order> &open_order)
 {
-    auto market_price = this->get_market_price(open_order->get_asset_id());
+    auto market_price = this->get_market_price(open_order->get_market_id());
     if (market_price == 0)
     {
         throw std::invalid_argument("received order for which asset is not currently streaming");
@@ -264,7 +666,7 @@ void Exchange::process_take_profit_order(shared_ptr<Order> &open_order)
 void Exchange::process_order(shared_ptr<Order> &order)
 {
     auto asset_id = order->get_asset_id();
-    auto asset = this->market_view.at(asset_id);
+    auto asset = this->market_view[this->resolve_market_id(*order)];
 
     // check to see if asset is currently streaming
     if (!asset)
@@ -345,32 +747,60 @@ void Exchange::move_expired_assets(){
             auto asset_id = asset->get_asset_id();
             
             //remove asset from market and market view
-            this->market_view.erase(asset_id);
+            this->market_view[asset->market_id] = nullptr;
             this->market.erase(asset_id);
+
+            // release the data of lazy assets, they are paged back in if the exchange is reset
+            asset->page_out();
         }
     }
 }
 
+size_t Exchange::get_arena_request() const
+{
+    size_t request = 0;
+    for(const auto& asset_pair : this->market){
+        request += arena_align(asset_pair.second->get_owned_data_size());
+    }
+    return request;
+}
+
+void Exchange::move_assets_to_arena(const shared_ptr<Arena> &arena)
+{
+    for(auto& asset_pair : this->market){
+        auto& asset = asset_pair.second;
+        auto data_size = asset->get_owned_data_size();
+        if(!data_size){
+            continue;
+        }
+
+        // every asset in the arena keeps it alive, the whole block is freed with the last one
+        asset->move_data(static_cast<double*>(arena->allocate(data_size)), arena);
+        this->arena_size += arena_align(data_size);
+    }
+}
+
 void Exchange::goto_datetime(long long datetime)
 {
-    //goto date is beyond the datetime index
-   if(datetime >= this->datetime_index[this->datetime_index_length-1])
-    {
-        this->current_index = this->datetime_index_length;
+    // first bar at or after the datetime, the end of the index if there is none
+    this->current_index = this->datetime_index_sp->lower_bound(datetime);
+
+    // every asset moves with the exchange, assets with no rows left are expired again
+    auto expired = std::move(this->expired_assets);
+    this->expired_assets.clear();
+    for(auto& asset : expired){
+        this->market.insert({asset->get_asset_id(), asset});
     }
-    
-    // search for datetime in the index
-    for(int i = this->current_index; i < this->datetime_index_length; i++)
-    {   
-        //is >= right?
-        if(this->datetime_index[i] >= datetime)
-        {
-            this->current_index = i;
-            return;
+    for(auto& asset_pair : this->market){
+        asset_pair.second->goto_datetime(datetime);
+        if(asset_pair.second->is_last_view()){
+            this->expired_assets.push_back(asset_pair.second);
         }
     }
+    this->move_expired_assets();
 
-    throw std::runtime_error("failed to find datetime in exchange goto");    
+    // rebuild the active assets and market view for the new position
+    this->replay_activation_schedule();
 }
 
 bool Exchange::get_market_view()
@@ -384,44 +814,50 @@ bool Exchange::get_market_view()
     
     // set exchange time to compare to assets
     this->exchange_time = this->datetime_index[this->current_index];
-
-    // Define a lambda function that processes each asset
-    auto process_asset = [&](auto& _asset_pair) {
-        //access raw pointer
-        auto asset_raw_pointer = _asset_pair.second.get();
-
-        // if asset is alligned to exchange just step forward in time, clean up if needed 
-        if(asset_raw_pointer->is_alligned){
-            asset_raw_pointer->step();
-            if(asset_raw_pointer->is_last_view()){
-                expired_assets.push_back(_asset_pair.second);
+    if(this->is_schedule_stale){
+        this->replay_activation_schedule();
+    }
+
+    // only assets that start or pause streaming at this bar touch the market view
+    while(this->schedule_index < this->activation_schedule.size() 
+        && this->activation_schedule[this->schedule_index].position == this->current_index){
+        auto& event = this->activation_schedule[this->schedule_index++];
+        auto asset = event.asset;
+        if(event.is_activation){
+            // lazy assets are paged in right before they first enter the market view
+            if(!asset->get_is_resident()){
+                asset->page_in();
             }
-            return;
+            this->market_view[asset->market_id] = asset;
+            this->active_slots[asset->market_id] = this->active_assets.size();
+            this->active_assets.push_back(asset);
         }
-
-        // get the asset's current time and id
-        auto asset_datetime = asset_raw_pointer->get_asset_time();
-        auto asset_id = asset_raw_pointer->get_asset_id(); 
-        if (asset_datetime && *asset_datetime == this->exchange_time)
-        {   
-            // add asset to market view, step the asset forward in time
-            this->market_view[asset_id] = asset_raw_pointer;
-            asset_raw_pointer->step();
-
-            // test to see if this is the last row of data for the asset
-            if(asset_raw_pointer->is_last_view()){
-                expired_assets.push_back(_asset_pair.second);
-            } 
+        else{
+            this->market_view[asset->market_id] = nullptr;
+            auto slot = this->active_slots[asset->market_id];
+            if(slot != NO_ACTIVE_SLOT){
+                auto last = this->active_assets.back();
+                this->active_assets[slot] = last;
+                this->active_slots[last->market_id] = slot;
+                this->active_assets.pop_back();
+                this->active_slots[asset->market_id] = NO_ACTIVE_SLOT;
+            }
         }
-        else
-        {
-            this->market_view[asset_id] = nullptr;
+    }
+
+    // step every streaming asset forward in time, assets on their last row are done streaming
+    size_t kept = 0;
+    for(auto asset : this->active_assets){
+        asset->step();
+        if(asset->is_last_view()){
+            this->expired_assets.push_back(this->market.at(asset->asset_id));
+            this->active_slots[asset->market_id] = NO_ACTIVE_SLOT;
+            continue;
         }
-    };
-    std::for_each(
-        this->market.begin(), 
-        this->market.end(), 
-        process_asset);
+        this->active_slots[asset->market_id] = kept;
+        this->active_assets[kept++] = asset;
+    }
+    this->active_assets.resize(kept);
 
     // move to next datetime and return true showing the market contains at least one
     // asset that is not done streaming
@@ -430,11 +866,11 @@ bool Exchange::get_market_view()
 }
 
 optional<double> Exchange::get_asset_feature(const string& asset_id, const string& column_name, int index){
-    auto asset_sp = this->market_view.at(asset_id);
-    
-    #ifdef ARGUS_RUNTIME_ASSERT
-    assert(asset_sp);
-    #endif
+    // expired assets keep their market id with an empty slot
+    auto asset_sp = this->market_view[this->get_market_id(asset_id)];
+    if(!asset_sp){
+        throw std::out_of_range(fmt::format("asset {} is not streaming", asset_id));
+    }
 
     auto asset_value = asset_sp->get_asset_feature(column_name, index);
     return asset_value;
@@ -456,23 +892,44 @@ py::dict Exchange::get_exchange_feature(
         number_assets = static_cast<size_t>(N);
     }
     
+    // the column is looked up once per distinct schema instead of once per asset
+    const Schema *last_schema = nullptr;
+    size_t column_index = SCHEMA_NO_COLUMN;
+    auto get_feature = [&](Asset *asset, double &value)
+    {
+        auto schema = asset->get_schema().get();
+        if(schema != last_schema){
+            last_schema = schema;
+            column_index = schema->find(column);
+        }
+        if(column_index != SCHEMA_NO_COLUMN){
+            value = asset->get_asset_feature(column_index, row);
+            return true;
+        }
+        if(asset->has_indicator(column)){
+            value = asset->get_asset_feature(column, row);
+            return true;
+        }
+        return false;
+    };
+
     py::dict py_dict;
     // default query type implies just find all assets with the feature
     if(query_type == ExchangeQueryType::Default)
     {
         int i = 0;
-        for(auto it = this->market_view.begin(); it != this->market_view.end(); it++)
+        for(auto asset_sp : this->market_view)
         {
             if(i == number_assets)
             {
                 return py_dict;
             }
             //check if asset is streaming
-            auto asset_sp = it->second;
-            if(asset_sp)
+            double asset_value;
+            if(asset_sp && get_feature(asset_sp, asset_value))
             {
                 //place the value in the dict if the asset has that feature, else skip
-                py_dict[it->first.c_str()] = asset_sp->get_asset_feature(column, row);
+                py_dict[asset_sp->asset_id.c_str()] = asset_value;
             }
             else
             {
@@ -484,15 +941,14 @@ py::dict Exchange::get_exchange_feature(
     }
     // query needs to be sorted, therefore we need to look at all possible assets
     std::vector<std::pair<std::string, double>> asset_pairs;
-    for(auto it = this->market_view.begin(); it != this->market_view.end(); it++)
+    for(auto asset_sp : this->market_view)
     {
         //check if asset is streaming
-        auto asset_sp = it->second;
-        if(asset_sp)
+        double asset_value;
+        if(asset_sp && get_feature(asset_sp, asset_value))
         {
             //place the value in the dict if the asset has that feature, else skip
-            auto asset_value = asset_sp->get_asset_feature(column, row);
-            asset_pairs.emplace_back(std::make_pair(it->first.c_str(),asset_value));
+            asset_pairs.emplace_back(std::make_pair(asset_sp->asset_id, asset_value));
             
         }
     }
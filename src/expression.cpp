@@ -0,0 +1,676 @@
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "fmt/core.h"
+#include "tsl/robin_map.h"
+
+#include "asset.h"
+#include "expression.h"
+#include "feature_cache.h"
+
+using namespace std;
+
+/**
+ * @brief recursive descent parser emitting the operations of an expression as it goes
+ *
+ *        expr    := term (('+' | '-') term)*
+ *        term    := unary (('*' | '/') unary)*
+ *        unary   := '-' unary | primary
+ *        primary := number | column | function '(' expr [',' number] ')' | '(' expr ')'
+ */
+class ExpressionParser
+{
+public:
+    ExpressionParser(Expression &expression_) : expression(expression_), source(expression_.source) {}
+
+    void parse()
+    {
+        this->expression.result = this->parse_expr();
+        this->skip_space();
+        if (this->position != this->source.size())
+        {
+            this->fail("unexpected character");
+        }
+    }
+
+private:
+    Expression &expression;
+    const string &source;
+    size_t position = 0;
+
+    [[noreturn]] void fail(const string &message) const
+    {
+        throw std::runtime_error(fmt::format(
+            "invalid expression \"{}\": {} at position {}", this->source, message, this->position));
+    }
+
+    void skip_space()
+    {
+        while (this->position < this->source.size() && std::isspace(static_cast<unsigned char>(this->source[this->position])))
+        {
+            this->position++;
+        }
+    }
+
+    bool accept(char c)
+    {
+        this->skip_space();
+        if (this->position < this->source.size() && this->source[this->position] == c)
+        {
+            this->position++;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char c)
+    {
+        if (!this->accept(c))
+        {
+            this->fail(fmt::format("expected '{}'", c));
+        }
+    }
+
+    ExpressionOperand emit(ExpressionOp op)
+    {
+        this->expression.ops.push_back(std::move(op));
+        ExpressionOperand operand;
+        operand.op_index = this->expression.ops.size() - 1;
+        return operand;
+    }
+
+    ExpressionOperand emit_binary(ExpressionOpCode code, ExpressionOperand lhs, ExpressionOperand rhs)
+    {
+        // fold operations on two constants at compile time
+        if (lhs.is_constant && rhs.is_constant)
+        {
+            ExpressionOperand folded;
+            folded.is_constant = true;
+            switch (code)
+            {
+            case Add: folded.constant = lhs.constant + rhs.constant; break;
+            case Subtract: folded.constant = lhs.constant - rhs.constant; break;
+            case Multiply: folded.constant = lhs.constant * rhs.constant; break;
+            default: folded.constant = lhs.constant / rhs.constant; break;
+            }
+            return folded;
+        }
+        ExpressionOp op;
+        op.code = code;
+        op.lhs = lhs;
+        op.rhs = rhs;
+        return this->emit(std::move(op));
+    }
+
+    ExpressionOperand parse_expr()
+    {
+        auto lhs = this->parse_term();
+        while (true)
+        {
+            if (this->accept('+'))
+            {
+                lhs = this->emit_binary(Add, lhs, this->parse_term());
+            }
+            else if (this->accept('-'))
+            {
+                lhs = this->emit_binary(Subtract, lhs, this->parse_term());
+            }
+            else
+            {
+                return lhs;
+            }
+        }
+    }
+
+    ExpressionOperand parse_term()
+    {
+        auto lhs = this->parse_unary();
+        while (true)
+        {
+            if (this->accept('*'))
+            {
+                lhs = this->emit_binary(Multiply, lhs, this->parse_unary());
+            }
+            else if (this->accept('/'))
+            {
+                lhs = this->emit_binary(Divide, lhs, this->parse_unary());
+            }
+            else
+            {
+                return lhs;
+            }
+        }
+    }
+
+    ExpressionOperand parse_unary()
+    {
+        if (this->accept('-'))
+        {
+            auto operand = this->parse_unary();
+            if (operand.is_constant)
+            {
+                operand.constant = -operand.constant;
+                return operand;
+            }
+            ExpressionOp op;
+            op.code = Negate;
+            op.lhs = operand;
+            return this->emit(std::move(op));
+        }
+        return this->parse_primary();
+    }
+
+    double parse_number()
+    {
+        this->skip_space();
+        auto start = this->source.c_str() + this->position;
+        char *end = nullptr;
+        auto value = std::strtod(start, &end);
+        if (end == start)
+        {
+            this->fail("expected a number");
+        }
+        this->position += end - start;
+        return value;
+    }
+
+    string parse_identifier()
+    {
+        auto start = this->position;
+        while (this->position < this->source.size())
+        {
+            auto c = static_cast<unsigned char>(this->source[this->position]);
+            if (!std::isalnum(c) && c != '_')
+            {
+                break;
+            }
+            this->position++;
+        }
+        return this->source.substr(start, this->position - start);
+    }
+
+    ExpressionOperand load_column(string column)
+    {
+        // every column is only loaded once, later references share the first load
+        auto &columns = this->expression.columns;
+        if (std::find(columns.begin(), columns.end(), column) != columns.end())
+        {
+            auto &ops = this->expression.ops;
+            for (size_t k = 0; k < ops.size(); k++)
+            {
+                if (ops[k].code == LoadColumn && ops[k].column == column)
+                {
+                    ExpressionOperand operand;
+                    operand.op_index = k;
+                    return operand;
+                }
+            }
+        }
+        columns.push_back(column);
+        ExpressionOp op;
+        op.code = LoadColumn;
+        op.column = std::move(column);
+        return this->emit(std::move(op));
+    }
+
+    ExpressionOperand parse_function(const string &name)
+    {
+        static const tsl::robin_map<string, ExpressionOpCode> functions = {
+            {"lag", Lag},
+            {"rolling_mean", RollingMean},
+            {"rolling_std", RollingStd},
+            {"rolling_min", RollingMin},
+            {"rolling_max", RollingMax},
+            {"ewm", Ewm}};
+        auto function = functions.find(name);
+        if (function == functions.end())
+        {
+            this->fail(fmt::format("unknown function {}", name));
+        }
+
+        auto operand = this->parse_expr();
+        this->expect(',');
+        auto window = this->parse_number();
+        this->expect(')');
+        if (!std::isfinite(window) || window > static_cast<double>(EXPRESSION_MAX_WINDOW))
+        {
+            this->fail(fmt::format("{} window can be at most {} rows", name, EXPRESSION_MAX_WINDOW));
+        }
+        if (window < 0 || window != std::floor(window) || (window == 0 && function->second != Lag))
+        {
+            this->fail(fmt::format("{} needs a {} whole number of rows", name,
+                function->second == Lag ? "non-negative" : "positive"));
+        }
+        if (operand.is_constant)
+        {
+            this->fail(fmt::format("{} needs a column", name));
+        }
+
+        ExpressionOp op;
+        op.code = function->second;
+        op.lhs = operand;
+        op.window = static_cast<size_t>(window);
+        return this->emit(std::move(op));
+    }
+
+    ExpressionOperand parse_primary()
+    {
+        this->skip_space();
+        if (this->position == this->source.size())
+        {
+            this->fail("unexpected end");
+        }
+
+        auto c = this->source[this->position];
+        if (c == '(')
+        {
+            this->position++;
+            auto operand = this->parse_expr();
+            this->expect(')');
+            return operand;
+        }
+        if (c == '`')
+        {
+            // quoted column names can hold any character but a backtick
+            auto end = this->source.find('`', this->position + 1);
+            if (end == string::npos)
+            {
+                this->fail("unterminated column name");
+            }
+            auto column = this->source.substr(this->position + 1, end - this->position - 1);
+            this->position = end + 1;
+            return this->load_column(std::move(column));
+        }
+        if (std::isdigit(static_cast<unsigned char>(c)) || c == '.')
+        {
+            ExpressionOperand operand;
+            operand.is_constant = true;
+            operand.constant = this->parse_number();
+            return operand;
+        }
+        if (std::isalpha(static_cast<unsigned char>(c)) || c == '_')
+        {
+            auto identifier = this->parse_identifier();
+            if (this->accept('('))
+            {
+                return this->parse_function(identifier);
+            }
+            return this->load_column(std::move(identifier));
+        }
+        this->fail("unexpected character");
+    }
+};
+
+Expression::Expression(string source_) : source(std::move(source_))
+{
+    ExpressionParser(*this).parse();
+}
+
+/// read an operand at a row, constants are broadcast
+static inline double operand_value(const ExpressionOperand &operand, const vector<vector<double>> &values, size_t row)
+{
+    return operand.is_constant ? operand.constant : values[operand.op_index][row];
+}
+
+template <typename Func>
+static void binary_kernel(const ExpressionOperand &lhs, const ExpressionOperand &rhs, const vector<vector<double>> &values, double *out, size_t rows, Func func)
+{
+    // separate loops for each operand kind keep the inner loops branch free so they vectorize
+    if (lhs.is_constant)
+    {
+        auto a = lhs.constant;
+        auto b = values[rhs.op_index].data();
+        for (size_t i = 0; i < rows; i++) out[i] = func(a, b[i]);
+    }
+    else if (rhs.is_constant)
+    {
+        auto a = values[lhs.op_index].data();
+        auto b = rhs.constant;
+        for (size_t i = 0; i < rows; i++) out[i] = func(a[i], b);
+    }
+    else
+    {
+        auto a = values[lhs.op_index].data();
+        auto b = values[rhs.op_index].data();
+        for (size_t i = 0; i < rows; i++) out[i] = func(a[i], b[i]);
+    }
+}
+
+static void lag_kernel(const double *in, double *out, size_t rows, size_t window)
+{
+    auto shifted = std::min(window, rows);
+    std::fill(out, out + shifted, NAN);
+    std::copy(in, in + rows - shifted, out + shifted);
+}
+
+static void rolling_moments_kernel(const double *in, double *out, size_t rows, size_t window, bool is_std)
+{
+    // running mean and sum of squared deviations over the window (welford with removal), values
+    // that are nan are left out of the sums and poison every window they are in
+    double mean = 0;
+    double m2 = 0;
+    size_t count = 0;
+    size_t nan_count = 0;
+    for (size_t i = 0; i < rows; i++)
+    {
+        auto value = in[i];
+        if (std::isnan(value))
+        {
+            nan_count++;
+        }
+        else
+        {
+            count++;
+            auto delta = value - mean;
+            mean += delta / count;
+            m2 += delta * (value - mean);
+        }
+
+        if (i >= window)
+        {
+            auto removed = in[i - window];
+            if (std::isnan(removed))
+            {
+                nan_count--;
+            }
+            else if (--count == 0)
+            {
+                mean = 0;
+                m2 = 0;
+            }
+            else
+            {
+                auto delta = removed - mean;
+                mean -= delta / count;
+                m2 -= delta * (removed - mean);
+            }
+        }
+
+        if (i + 1 < window || nan_count)
+        {
+            out[i] = NAN;
+        }
+        else if (is_std)
+        {
+            out[i] = window > 1 ? std::sqrt(std::max(m2, 0.0) / (window - 1)) : NAN;
+        }
+        else
+        {
+            out[i] = mean;
+        }
+    }
+}
+
+template <typename Compare>
+static void rolling_extreme_kernel(const double *in, double *out, size_t rows, size_t window, Compare compare)
+{
+    // monotonic queue of row indexes, the front is always the extreme of the window
+    std::deque<size_t> candidates;
+    size_t nan_count = 0;
+    for (size_t i = 0; i < rows; i++)
+    {
+        if (std::isnan(in[i]))
+        {
+            nan_count++;
+        }
+        else
+        {
+            while (!candidates.empty() && !compare(in[candidates.back()], in[i]))
+            {
+                candidates.pop_back();
+            }
+            candidates.push_back(i);
+        }
+
+        if (i >= window)
+        {
+            if (std::isnan(in[i - window]))
+            {
+                nan_count--;
+            }
+            if (!candidates.empty() && candidates.front() == i - window)
+            {
+                candidates.pop_front();
+            }
+        }
+
+        out[i] = (i + 1 < window || nan_count) ? NAN : in[candidates.front()];
+    }
+}
+
+static void ewm_kernel(const double *in, double *out, size_t rows, size_t span)
+{
+    // adjusted exponentially weighted mean, nan values decay the weights but add nothing
+    auto decay = 1.0 - 2.0 / (span + 1.0);
+    double numerator = 0;
+    double denominator = 0;
+    for (size_t i = 0; i < rows; i++)
+    {
+        numerator *= decay;
+        denominator *= decay;
+        if (!std::isnan(in[i]))
+        {
+            numerator += in[i];
+            denominator += 1;
+        }
+        out[i] = denominator > 0 ? numerator / denominator : NAN;
+    }
+}
+
+void Expression::evaluate(const std::function<const double *(const string &)> &column, size_t rows, double *out) const
+{
+    if (this->result.is_constant)
+    {
+        std::fill(out, out + rows, this->result.constant);
+        return;
+    }
+
+    // every operation writes its own column, the last one is the result
+    vector<vector<double>> values(this->ops.size());
+    for (size_t k = 0; k < this->ops.size(); k++)
+    {
+        auto &op = this->ops[k];
+        auto &value = values[k];
+        value.resize(rows);
+        auto out_k = value.data();
+        switch (op.code)
+        {
+        case LoadColumn:
+        {
+            auto in = column(op.column);
+            std::copy(in, in + rows, out_k);
+            break;
+        }
+        case Add:
+            binary_kernel(op.lhs, op.rhs, values, out_k, rows, [](double a, double b) { return a + b; });
+            break;
+        case Subtract:
+            binary_kernel(op.lhs, op.rhs, values, out_k, rows, [](double a, double b) { return a - b; });
+            break;
+        case Multiply:
+            binary_kernel(op.lhs, op.rhs, values, out_k, rows, [](double a, double b) { return a * b; });
+            break;
+        case Divide:
+            binary_kernel(op.lhs, op.rhs, values, out_k, rows, [](double a, double b) { return a / b; });
+            break;
+        case Negate:
+        {
+            auto in = values[op.lhs.op_index].data();
+            for (size_t i = 0; i < rows; i++) out_k[i] = -in[i];
+            break;
+        }
+        case Lag:
+            lag_kernel(values[op.lhs.op_index].data(), out_k, rows, op.window);
+            break;
+        case RollingMean:
+            rolling_moments_kernel(values[op.lhs.op_index].data(), out_k, rows, op.window, false);
+            break;
+        case RollingStd:
+            rolling_moments_kernel(values[op.lhs.op_index].data(), out_k, rows, op.window, true);
+            break;
+        case RollingMin:
+            rolling_extreme_kernel(values[op.lhs.op_index].data(), out_k, rows, op.window, std::less<>());
+            break;
+        case RollingMax:
+            rolling_extreme_kernel(values[op.lhs.op_index].data(), out_k, rows, op.window, std::greater<>());
+            break;
+        case Ewm:
+            ewm_kernel(values[op.lhs.op_index].data(), out_k, rows, op.window);
+            break;
+        }
+    }
+
+    auto &last = values[this->result.op_index];
+    std::copy(last.begin(), last.end(), out);
+}
+
+size_t Expression::get_lookback() const
+{
+    // windows of nested operations add up, summing every operation's window is an upper bound
+    size_t lookback = 0;
+    for (const auto &op : this->ops)
+    {
+        switch (op.code)
+        {
+        case Ewm:
+            return SIZE_MAX;
+        case Lag:
+            lookback += op.window;
+            break;
+        case RollingMean:
+        case RollingStd:
+        case RollingMin:
+        case RollingMax:
+            lookback += op.window - 1;
+            break;
+        default:
+            break;
+        }
+    }
+    return lookback;
+}
+
+void update_derived_columns(Asset &asset, const vector<DerivedColumn> &derived_columns, size_t first_row)
+{
+    auto rows = asset.get_rows();
+    if (first_row >= rows)
+    {
+        return;
+    }
+    for (const auto &derived : derived_columns)
+    {
+        auto lookback = derived.expression.get_lookback();
+        auto start = lookback >= first_row ? 0 : first_row - lookback;
+        auto window_rows = rows - start;
+
+        // only the window is copied out, derived columns before this one were already updated
+        tsl::robin_map<string, vector<double>> columns;
+        auto lookup = [&](const string &name) -> const double *
+        {
+            auto it = columns.find(name);
+            if (it != columns.end())
+            {
+                return it->second.data();
+            }
+            auto column_index = asset.get_column_index(name);
+            vector<double> values(window_rows);
+            for (size_t i = 0; i < window_rows; i++)
+            {
+                values[i] = asset.read_value(column_index, start + i);
+            }
+            return columns.emplace(name, std::move(values)).first->second.data();
+        };
+
+        vector<double> result(window_rows);
+        derived.expression.evaluate(lookup, window_rows, result.data());
+        asset.write_column(asset.get_column_index(derived.name), first_row, result.data() + (first_row - start), rows - first_row);
+    }
+}
+
+void add_derived_columns(Asset &asset, const vector<DerivedColumn> &derived_columns, FeatureCache *cache)
+{
+    auto rows = asset.get_rows();
+
+    // the asset's columns are copied out once, derived columns are added to the lookup as they are computed
+    tsl::robin_map<string, vector<double>> columns;
+    auto column_names = asset.get_column_names();
+    auto lookup = [&](const string &name) -> const double *
+    {
+        auto it = columns.find(name);
+        if (it != columns.end())
+        {
+            return it->second.data();
+        }
+        auto column_index = std::find(column_names.begin(), column_names.end(), name);
+        if (column_index == column_names.end())
+        {
+            throw std::runtime_error(fmt::format("asset {} has no column {}", asset.get_asset_id(), name));
+        }
+        vector<double> values(rows);
+        asset.copy_column(column_index - column_names.begin(), values.data());
+        return columns.emplace(name, std::move(values)).first->second.data();
+    };
+
+    // derived columns follow the source columns, the ones added by an earlier build are kept as they are
+    auto source_cols = column_names.size() - asset.get_derived_cols();
+    // the datetime index is part of every cache key, a regular index is only expanded for the keys
+    vector<long long> datetime_index;
+    if (cache)
+    {
+        datetime_index.resize(rows);
+        asset.copy_datetime_index(0, rows, datetime_index.data());
+    }
+
+    vector<string> names;
+    vector<double> values;
+    for (const auto &derived : derived_columns)
+    {
+        auto existing = std::find(column_names.begin(), column_names.end(), derived.name);
+        if (existing != column_names.end())
+        {
+            if (static_cast<size_t>(existing - column_names.begin()) < source_cols)
+            {
+                throw std::runtime_error(fmt::format(
+                    "derived column {} collides with a column of asset {}", derived.name, asset.get_asset_id()));
+            }
+            continue;
+        }
+        vector<double> result(rows);
+        if (!cache)
+        {
+            derived.expression.evaluate(lookup, rows, result.data());
+        }
+        else
+        {
+            // the key covers the expression, the datetime index and every column the expression reads
+            auto &source = derived.expression.get_source();
+            auto key = fingerprint(source.data(), source.size());
+            key = fingerprint(datetime_index.data(), rows * sizeof(long long), key);
+            for (const auto &column : derived.expression.get_columns())
+            {
+                key = fingerprint(column.data(), column.size(), key);
+                key = fingerprint(lookup(column), rows * sizeof(double), key);
+            }
+            if (!cache->load(key, rows, result.data()))
+            {
+                derived.expression.evaluate(lookup, rows, result.data());
+                cache->store(key, result.data(), rows);
+            }
+        }
+        values.insert(values.end(), result.begin(), result.end());
+        names.push_back(derived.name);
+        columns.insert_or_assign(derived.name, std::move(result));
+    }
+
+    if (!names.empty())
+    {
+        asset.add_columns(names, values.data(), true);
+    }
+}
@@ -0,0 +1,629 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/mman.h>
+
+#include "fmt/core.h"
+
+#include "asset.h"
+#include "asset_file.h"
+#include "datetime_index.h"
+#include "feather_reader.h"
+#include "settings.h"
+#include "utils_string.h"
+#include "utils_time.h"
+
+using namespace std;
+
+/// arrow Type union ids (Schema.fbs) that the reader knows about
+enum ArrowTypeId
+{
+    ArrowNull = 1,
+    ArrowInt = 2,
+    ArrowFloatingPoint = 3,
+    ArrowBinary = 4,
+    ArrowUtf8 = 5,
+    ArrowBool = 6,
+    ArrowDecimal = 7,
+    ArrowDate = 8,
+    ArrowTime = 9,
+    ArrowTimestamp = 10,
+    ArrowInterval = 11,
+    ArrowFixedSizeBinary = 15,
+    ArrowDuration = 18,
+    ArrowLargeBinary = 19,
+    ArrowLargeUtf8 = 20
+};
+
+/// arrow MessageHeader union id of a record batch
+static constexpr uint8_t ARROW_RECORD_BATCH = 3;
+
+/// size of the Block, FieldNode and Buffer structs in the arrow metadata
+static constexpr size_t ARROW_BLOCK_SIZE = 24;
+static constexpr size_t ARROW_FIELD_NODE_SIZE = 16;
+static constexpr size_t ARROW_BUFFER_SIZE = 16;
+
+/// how a column of the file is read
+enum FeatherColumnKind
+{
+    FeatherSkip,
+    FeatherInt,
+    FeatherFloat,
+    FeatherBool,
+    FeatherTimestamp
+};
+
+/// a top level column of the feather file
+struct FeatherColumn
+{
+    string name;
+    FeatherColumnKind kind = FeatherSkip;
+
+    /// width of a value in bits and if integers are signed
+    int bit_width = 0;
+    bool is_signed = true;
+
+    /// multiplier converting timestamp and date values to ns
+    long long scale = 1;
+
+    /// number of buffers the column uses in a record batch
+    size_t buffer_count = 2;
+};
+
+/// location of a column's buffers in a single record batch
+struct FeatherSlice
+{
+    const uint8_t *validity = nullptr;
+    const char *values = nullptr;
+    int64_t null_count = 0;
+};
+
+/// a record batch of the feather file
+struct FeatherBatch
+{
+    size_t rows = 0;
+    vector<FeatherSlice> slices;
+};
+
+/// buffers a feather asset views, the mapping is only kept if the asset points into it
+struct FeatherAssetBuffers
+{
+    shared_ptr<MappedFile> file;
+    vector<double> data;
+};
+
+template <typename T>
+static T read_value(const char *base, size_t size, size_t position)
+{
+    if (position > size || size - position < sizeof(T))
+    {
+        ARGUS_RUNTIME_ERROR("feather file is corrupt");
+    }
+    T value;
+    memcpy(&value, base + position, sizeof(T));
+    return value;
+}
+
+/**
+ * @brief bounds checked read only accessor for a flatbuffer table inside of the mapped file
+ */
+class FlatTable
+{
+public:
+    FlatTable(const char *base_, size_t size_, size_t position_) : base(base_), size(size_), position(position_)
+    {
+        auto vtable_offset = read_value<int32_t>(base, size, position);
+        auto vtable_position = static_cast<int64_t>(position) - vtable_offset;
+        if (vtable_position < 0 || static_cast<size_t>(vtable_position) >= size)
+        {
+            ARGUS_RUNTIME_ERROR("feather file is corrupt");
+        }
+        this->vtable = static_cast<size_t>(vtable_position);
+        this->vtable_size = read_value<uint16_t>(base, size, this->vtable);
+    }
+
+    /// is the field present in the table
+    [[nodiscard]] bool has(int field) const { return this->field_position(field) != 0; }
+
+    /// read a scalar field, default value if it is not present
+    template <typename T>
+    [[nodiscard]] T scalar(int field, T default_value) const
+    {
+        auto field_position = this->field_position(field);
+        return field_position ? read_value<T>(base, size, field_position) : default_value;
+    }
+
+    /// read a sub table field
+    [[nodiscard]] FlatTable table(int field) const
+    {
+        auto target = this->offset_target(field);
+        if (!target)
+        {
+            ARGUS_RUNTIME_ERROR("feather file is missing required metadata");
+        }
+        return {base, size, target};
+    }
+
+    /// read a string field, empty if it is not present
+    [[nodiscard]] string str(int field) const
+    {
+        auto target = this->offset_target(field);
+        if (!target)
+        {
+            return "";
+        }
+        auto length = read_value<uint32_t>(base, size, target);
+        if (target + 4 + length > size)
+        {
+            ARGUS_RUNTIME_ERROR("feather file is corrupt");
+        }
+        return {base + target + 4, length};
+    }
+
+    /// number of elements in a vector field, 0 if it is not present
+    [[nodiscard]] size_t vector_length(int field) const
+    {
+        auto target = this->offset_target(field);
+        return target ? read_value<uint32_t>(base, size, target) : 0;
+    }
+
+    /// read the i'th table of a vector of tables
+    [[nodiscard]] FlatTable vector_table(int field, size_t i) const
+    {
+        auto element = this->vector_element(field, i, 4);
+        return {base, size, element + read_value<uint32_t>(base, size, element)};
+    }
+
+    /// read a member of the i'th struct of a vector of structs
+    template <typename T>
+    [[nodiscard]] T vector_struct(int field, size_t i, size_t struct_size, size_t member_offset) const
+    {
+        return read_value<T>(base, size, this->vector_element(field, i, struct_size) + member_offset);
+    }
+
+private:
+    const char *base;
+    size_t size;
+    size_t position;
+    size_t vtable;
+    uint16_t vtable_size;
+
+    /// absolute position of a field, 0 if the field is not present
+    [[nodiscard]] size_t field_position(int field) const
+    {
+        size_t entry = 4 + 2 * static_cast<size_t>(field);
+        if (entry + 2 > this->vtable_size)
+        {
+            return 0;
+        }
+        auto offset = read_value<uint16_t>(base, size, this->vtable + entry);
+        return offset ? this->position + offset : 0;
+    }
+
+    /// absolute position an offset field points to, 0 if the field is not present
+    [[nodiscard]] size_t offset_target(int field) const
+    {
+        auto field_position = this->field_position(field);
+        return field_position ? field_position + read_value<uint32_t>(base, size, field_position) : 0;
+    }
+
+    /// absolute position of the i'th element of a vector field
+    [[nodiscard]] size_t vector_element(int field, size_t i, size_t element_size) const
+    {
+        if (i >= this->vector_length(field))
+        {
+            ARGUS_RUNTIME_ERROR("feather file is corrupt");
+        }
+        return this->offset_target(field) + 4 + i * element_size;
+    }
+};
+
+/// timestamp unit (SECOND, MILLISECOND, MICROSECOND, NANOSECOND) to ns
+static long long timestamp_unit_scale(int16_t unit)
+{
+    static constexpr long long scales[] = {1000000000LL, 1000000LL, 1000LL, 1LL};
+    if (unit < 0 || unit > 3)
+    {
+        ARGUS_RUNTIME_ERROR("feather file has an invalid timestamp unit");
+    }
+    return scales[unit];
+}
+
+/// work out how a field of the schema is read
+static FeatherColumn parse_field(const FlatTable &field)
+{
+    FeatherColumn column;
+    column.name = field.str(0);
+
+    // dictionary encoded columns (i.e. categoricals) have a validity and an indices buffer
+    if (field.has(4))
+    {
+        return column;
+    }
+
+    auto type_id = field.scalar<uint8_t>(2, 0);
+    switch (type_id)
+    {
+    case ArrowInt:
+    {
+        auto type = field.table(3);
+        column.kind = FeatherInt;
+        column.bit_width = type.scalar<int32_t>(0, 0);
+        column.is_signed = type.scalar<uint8_t>(1, 0);
+        if (column.bit_width != 8 && column.bit_width != 16 && column.bit_width != 32 && column.bit_width != 64)
+        {
+            ARGUS_RUNTIME_ERROR(fmt::format("feather column {} has an invalid int width", column.name));
+        }
+        break;
+    }
+    case ArrowFloatingPoint:
+    {
+        // HALF = 0, SINGLE = 1, DOUBLE = 2
+        auto precision = field.table(3).scalar<int16_t>(0, 0);
+        if (precision == 0)
+        {
+            ARGUS_RUNTIME_ERROR(fmt::format("feather column {} is float16 which is not supported", column.name));
+        }
+        column.kind = FeatherFloat;
+        column.bit_width = precision == 1 ? 32 : 64;
+        break;
+    }
+    case ArrowBool:
+        column.kind = FeatherBool;
+        column.bit_width = 1;
+        break;
+    case ArrowTimestamp:
+        column.kind = FeatherTimestamp;
+        column.bit_width = 64;
+        column.scale = timestamp_unit_scale(field.has(3) ? field.table(3).scalar<int16_t>(0, 0) : 0);
+        break;
+    case ArrowDate:
+    {
+        // DAY = 0 stored as int32 days, MILLISECOND = 1 stored as int64 ms
+        auto unit = field.has(3) ? field.table(3).scalar<int16_t>(0, 1) : 1;
+        column.kind = FeatherTimestamp;
+        column.bit_width = unit == 0 ? 32 : 64;
+        column.scale = unit == 0 ? 86400LL * 1000000000LL : 1000000LL;
+        break;
+    }
+    case ArrowNull:
+        column.buffer_count = 0;
+        break;
+    case ArrowBinary:
+    case ArrowUtf8:
+    case ArrowLargeBinary:
+    case ArrowLargeUtf8:
+        column.buffer_count = 3;
+        break;
+    case ArrowDecimal:
+    case ArrowTime:
+    case ArrowInterval:
+    case ArrowFixedSizeBinary:
+    case ArrowDuration:
+        break;
+    default:
+        ARGUS_RUNTIME_ERROR(fmt::format("feather column {} has an unsupported nested type", column.name));
+    }
+    return column;
+}
+
+/// read a value of a numeric column as a double, nulls are NaN
+static inline double read_double(const FeatherColumn &column, const FeatherSlice &slice, size_t i)
+{
+    if (slice.validity && !((slice.validity[i >> 3] >> (i & 7)) & 1))
+    {
+        return NAN;
+    }
+    auto values = slice.values;
+    switch (column.kind)
+    {
+    case FeatherFloat:
+        if (column.bit_width == 64)
+        {
+            double value;
+            memcpy(&value, values + i * 8, 8);
+            return value;
+        }
+        else
+        {
+            float value;
+            memcpy(&value, values + i * 4, 4);
+            return value;
+        }
+    case FeatherBool:
+        return (reinterpret_cast<const uint8_t *>(values)[i >> 3] >> (i & 7)) & 1;
+    default:
+        break;
+    }
+
+    switch (column.bit_width)
+    {
+    case 8:
+        return column.is_signed ? static_cast<double>(reinterpret_cast<const int8_t *>(values)[i])
+                                : static_cast<double>(reinterpret_cast<const uint8_t *>(values)[i]);
+    case 16:
+    {
+        uint16_t value;
+        memcpy(&value, values + i * 2, 2);
+        return column.is_signed ? static_cast<double>(static_cast<int16_t>(value)) : static_cast<double>(value);
+    }
+    case 32:
+    {
+        uint32_t value;
+        memcpy(&value, values + i * 4, 4);
+        return column.is_signed ? static_cast<double>(static_cast<int32_t>(value)) : static_cast<double>(value);
+    }
+    default:
+    {
+        uint64_t value;
+        memcpy(&value, values + i * 8, 8);
+        return column.is_signed ? static_cast<double>(static_cast<int64_t>(value)) : static_cast<double>(value);
+    }
+    }
+}
+
+/// read a value of the datetime column as a ns epoch timestamp
+static inline long long read_datetime(const FeatherColumn &column, const FeatherSlice &slice, size_t i, long long epoch_scale)
+{
+    if (slice.validity && !((slice.validity[i >> 3] >> (i & 7)) & 1))
+    {
+        ARGUS_RUNTIME_ERROR(fmt::format("feather datetime column {} contains nulls", column.name));
+    }
+    if (column.kind == FeatherFloat)
+    {
+        return llround(read_double(column, slice, i) * static_cast<double>(epoch_scale));
+    }
+
+    int64_t value;
+    if (column.bit_width == 64)
+    {
+        memcpy(&value, slice.values + i * 8, 8);
+    }
+    else
+    {
+        value = static_cast<int64_t>(read_double(column, slice, i));
+    }
+    return value * (column.kind == FeatherTimestamp ? column.scale : epoch_scale);
+}
+
+shared_ptr<Asset> read_feather_file(
+    const string &path,
+    const string &asset_id,
+    const string &exchange_id,
+    const string &broker_id,
+    size_t warmup,
+    const string &datetime_column,
+    const string &epoch_unit)
+{
+    auto epoch_scale = epoch_unit_scale(epoch_unit);
+
+    auto file = make_shared<MappedFile>(path);
+    auto base = file->get_data();
+    auto size = file->get_size();
+
+    // arrow ipc files start and end with ARROW1, feather v1 files use FEA1
+    if (size >= 4 && memcmp(base, "FEA1", 4) == 0)
+    {
+        ARGUS_RUNTIME_ERROR(fmt::format("feather v1 files are not supported: {}", path));
+    }
+    if (size < 22 || memcmp(base, "ARROW1", 6) != 0 || memcmp(base + size - 6, "ARROW1", 6) != 0)
+    {
+        ARGUS_RUNTIME_ERROR(fmt::format("not an arrow ipc file: {}", path));
+    }
+
+    // the footer flatbuffer sits right before its int32 length and the trailing magic
+    auto footer_length = read_value<int32_t>(base, size, size - 10);
+    if (footer_length <= 0 || static_cast<size_t>(footer_length) > size - 18)
+    {
+        ARGUS_RUNTIME_ERROR(fmt::format("feather file is corrupt: {}", path));
+    }
+    auto footer_position = size - 10 - footer_length;
+    FlatTable footer(base, size, footer_position + read_value<uint32_t>(base, size, footer_position));
+
+    // parse the schema
+    auto schema = footer.table(1);
+    if (schema.scalar<int16_t>(0, 0) != 0)
+    {
+        ARGUS_RUNTIME_ERROR(fmt::format("big endian feather files are not supported: {}", path));
+    }
+    vector<FeatherColumn> columns;
+    vector<string> names;
+    for (size_t i = 0; i < schema.vector_length(1); i++)
+    {
+        columns.push_back(parse_field(schema.vector_table(1, i)));
+        names.push_back(columns.back().name);
+    }
+    if (columns.empty())
+    {
+        ARGUS_RUNTIME_ERROR(fmt::format("feather file has no columns: {}", path));
+    }
+
+    size_t datetime_position = datetime_column.empty() ? 0 : case_ins_str_index(names, datetime_column);
+    auto &datetime_field = columns[datetime_position];
+    if (datetime_field.kind == FeatherSkip || datetime_field.kind == FeatherBool)
+    {
+        ARGUS_RUNTIME_ERROR(fmt::format("feather column {} can't be used as a datetime index", datetime_field.name));
+    }
+
+    // every numeric column other than the datetime column is a data column
+    vector<size_t> data_positions;
+    vector<string> column_names;
+    for (size_t i = 0; i < columns.size(); i++)
+    {
+        if (i != datetime_position && columns[i].kind != FeatherSkip && columns[i].kind != FeatherTimestamp)
+        {
+            data_positions.push_back(i);
+            column_names.push_back(columns[i].name);
+        }
+    }
+    if (data_positions.empty())
+    {
+        ARGUS_RUNTIME_ERROR(fmt::format("feather file has no numeric columns: {}", path));
+    }
+
+    // locate the buffers of every column in every record batch
+    vector<FeatherBatch> batches;
+    size_t rows = 0;
+    for (size_t b = 0; b < footer.vector_length(3); b++)
+    {
+        auto offset = footer.vector_struct<int64_t>(3, b, ARROW_BLOCK_SIZE, 0);
+        auto metadata_length = footer.vector_struct<int32_t>(3, b, ARROW_BLOCK_SIZE, 8);
+        auto body_length = footer.vector_struct<int64_t>(3, b, ARROW_BLOCK_SIZE, 16);
+        if (offset < 0 || metadata_length < 8 || body_length < 0
+            || static_cast<size_t>(offset + metadata_length + body_length) > size)
+        {
+            ARGUS_RUNTIME_ERROR(fmt::format("feather file is corrupt: {}", path));
+        }
+
+        // message flatbuffer, optionally prefixed by the 0xFFFFFFFF continuation marker
+        auto message_position = static_cast<size_t>(offset) + 4;
+        if (read_value<uint32_t>(base, size, static_cast<size_t>(offset)) == 0xFFFFFFFF)
+        {
+            message_position += 4;
+        }
+        FlatTable message(base, size, message_position + read_value<uint32_t>(base, size, message_position));
+        if (message.scalar<uint8_t>(1, 0) != ARROW_RECORD_BATCH)
+        {
+            ARGUS_RUNTIME_ERROR(fmt::format("feather file is corrupt: {}", path));
+        }
+        auto record_batch = message.table(2);
+        if (record_batch.has(3))
+        {
+            ARGUS_RUNTIME_ERROR(fmt::format(
+                "compressed feather files are not supported, write with compression='uncompressed': {}", path));
+        }
+
+        FeatherBatch batch;
+        batch.rows = static_cast<size_t>(record_batch.scalar<int64_t>(0, 0));
+        batch.slices.resize(columns.size());
+        auto body = static_cast<size_t>(offset + metadata_length);
+        size_t buffer_index = 0;
+        for (size_t i = 0; i < columns.size(); i++)
+        {
+            auto &column = columns[i];
+            auto &slice = batch.slices[i];
+            if (column.kind != FeatherSkip)
+            {
+                slice.null_count = record_batch.vector_struct<int64_t>(1, i, ARROW_FIELD_NODE_SIZE, 8);
+
+                auto validity_offset = record_batch.vector_struct<int64_t>(2, buffer_index, ARROW_BUFFER_SIZE, 0);
+                auto validity_length = record_batch.vector_struct<int64_t>(2, buffer_index, ARROW_BUFFER_SIZE, 8);
+                auto values_offset = record_batch.vector_struct<int64_t>(2, buffer_index + 1, ARROW_BUFFER_SIZE, 0);
+                auto values_length = record_batch.vector_struct<int64_t>(2, buffer_index + 1, ARROW_BUFFER_SIZE, 8);
+
+                auto required_length = static_cast<int64_t>((batch.rows * column.bit_width + 7) / 8);
+                if (values_offset < 0 || values_length < required_length || values_offset + values_length > body_length
+                    || validity_offset < 0 || validity_offset + validity_length > body_length)
+                {
+                    ARGUS_RUNTIME_ERROR(fmt::format("feather file is corrupt: {}", path));
+                }
+                if (slice.null_count > 0 && validity_length > 0)
+                {
+                    slice.validity = reinterpret_cast<const uint8_t *>(base + body + validity_offset);
+                }
+                slice.values = base + body + values_offset;
+            }
+            buffer_index += column.buffer_count;
+        }
+        rows += batch.rows;
+        batches.push_back(std::move(batch));
+    }
+    if (rows == 0)
+    {
+        ARGUS_RUNTIME_ERROR(fmt::format("feather file has no rows: {}", path));
+    }
+
+    auto cols = data_positions.size();
+    auto buffers = make_shared<FeatherAssetBuffers>();
+    double *data;
+    long long const *datetime_index = nullptr;
+    datetime_index_sp_t shared_index;
+
+    // view the data in place if it is a single batch of back to back float64 columns without nulls
+    bool data_in_place = batches.size() == 1;
+    for (size_t j = 0; j < cols && data_in_place; j++)
+    {
+        auto &column = columns[data_positions[j]];
+        auto &slice = batches[0].slices[data_positions[j]];
+        auto first_values = batches[0].slices[data_positions[0]].values;
+        data_in_place = column.kind == FeatherFloat && column.bit_width == 64 && slice.null_count == 0
+            && reinterpret_cast<uintptr_t>(slice.values) % alignof(double) == 0
+            && slice.values == first_values + j * rows * sizeof(double);
+    }
+    if (data_in_place)
+    {
+        data = reinterpret_cast<double *>(const_cast<char *>(batches[0].slices[data_positions[0]].values));
+        buffers->file = file;
+    }
+    else
+    {
+        buffers->data.resize(rows * cols);
+        size_t row_offset = 0;
+        for (auto &batch : batches)
+        {
+            for (size_t j = 0; j < cols; j++)
+            {
+                auto &column = columns[data_positions[j]];
+                auto &slice = batch.slices[data_positions[j]];
+                auto out = &buffers->data[j * rows + row_offset];
+                for (size_t i = 0; i < batch.rows; i++)
+                {
+                    out[i] = read_double(column, slice, i);
+                }
+            }
+            row_offset += batch.rows;
+        }
+        data = buffers->data.data();
+    }
+
+    // same for the datetime index if it already holds int64 ns timestamps
+    auto &datetime_slice = batches[0].slices[datetime_position];
+    bool index_in_place = batches.size() == 1 && datetime_slice.null_count == 0
+        && datetime_field.bit_width == 64 && datetime_field.kind != FeatherFloat
+        && (datetime_field.kind == FeatherTimestamp ? datetime_field.scale : epoch_scale) == 1
+        && reinterpret_cast<uintptr_t>(datetime_slice.values) % alignof(long long) == 0;
+    if (index_in_place)
+    {
+        datetime_index = reinterpret_cast<long long const *>(datetime_slice.values);
+        buffers->file = file;
+    }
+    else
+    {
+        vector<long long> converted_index(rows);
+        size_t row_offset = 0;
+        for (auto &batch : batches)
+        {
+            for (size_t i = 0; i < batch.rows; i++)
+            {
+                converted_index[row_offset + i] = read_datetime(
+                    datetime_field, batch.slices[datetime_position], i, epoch_scale);
+            }
+            row_offset += batch.rows;
+        }
+
+        // share the converted index with any other asset that has the same one
+        shared_index = intern_datetime_index(std::move(converted_index));
+    }
+
+    // the asset reads the mapping front to back as it streams
+    if (buffers->file)
+    {
+        file->advise(0, size, MADV_SEQUENTIAL);
+    }
+
+    auto asset = make_shared<Asset>(asset_id, exchange_id, broker_id, warmup);
+    asset->load_headers(column_names);
+    if (shared_index)
+    {
+        asset->load_view(data, shared_index, rows, cols, true, std::move(buffers));
+    }
+    else
+    {
+        asset->load_view(data, datetime_index, rows, cols, true, std::move(buffers));
+    }
+    return asset;
+}
@@ -0,0 +1,162 @@
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+#include "fmt/core.h"
+
+#include "asset_file.h"
+#include "feature_cache.h"
+#include "settings.h"
+
+using namespace std;
+
+/// alignment of the values inside of a cached feature file
+static constexpr uint64_t FEATURE_CACHE_ALIGNMENT = 64;
+
+/// multiply-xorshift step of a single fingerprint lane
+static inline uint64_t mix_word(uint64_t lane, uint64_t word)
+{
+    lane ^= word;
+    lane *= 0x9E3779B97F4A7C15ull;
+    return lane ^ (lane >> 29);
+}
+
+/// splitmix64 finalizer, spreads every input bit over the whole fingerprint
+static inline uint64_t finalize(uint64_t h)
+{
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBull;
+    return h ^ (h >> 31);
+}
+
+uint64_t fingerprint(const void *data, size_t size, uint64_t seed)
+{
+    auto bytes = static_cast<const unsigned char *>(data);
+    uint64_t lanes[4] = {seed, seed + 1, seed + 2, seed + 3};
+
+    // four independent lanes hide the latency of the multiply
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32)
+    {
+        for (size_t k = 0; k < 4; k++)
+        {
+            uint64_t word;
+            std::memcpy(&word, bytes + i + 8 * k, sizeof(word));
+            lanes[k] = mix_word(lanes[k], word);
+        }
+    }
+    for (; i + 8 <= size; i += 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, bytes + i, sizeof(word));
+        lanes[0] = mix_word(lanes[0], word);
+    }
+    if (i < size)
+    {
+        uint64_t word = 0;
+        std::memcpy(&word, bytes + i, size - i);
+        lanes[1] = mix_word(lanes[1], word);
+    }
+
+    uint64_t h = size;
+    for (auto lane : lanes)
+    {
+        h = finalize(h ^ lane);
+    }
+    return h;
+}
+
+FeatureCache::FeatureCache(string dir_path_) : dir_path(std::move(dir_path_))
+{
+    std::error_code error;
+    std::filesystem::create_directories(this->dir_path, error);
+    if (error)
+    {
+        ARGUS_RUNTIME_ERROR(fmt::format("failed to create feature cache {}: {}", this->dir_path, error.message()));
+    }
+}
+
+string FeatureCache::entry_path(uint64_t key) const
+{
+    return (std::filesystem::path(this->dir_path) / fmt::format("{:016x}.argusf", key)).string();
+}
+
+bool FeatureCache::load(uint64_t key, size_t rows, double *out)
+{
+    auto path = this->entry_path(key);
+    if (!std::filesystem::exists(path))
+    {
+        this->misses++;
+        return false;
+    }
+
+    // a damaged or mismatched entry is treated as a miss and overwritten by the next store
+    try
+    {
+        MappedFile file(path);
+        FeatureCacheHeader header{};
+        if (file.get_size() >= sizeof(header))
+        {
+            std::memcpy(&header, file.get_data(), sizeof(header));
+            auto is_valid = std::memcmp(header.magic, FEATURE_CACHE_MAGIC, sizeof(header.magic)) == 0
+                && header.version == FEATURE_CACHE_VERSION
+                && header.key == key
+                && header.rows == rows
+                && header.data_offset + rows * sizeof(double) <= file.get_size();
+            if (is_valid)
+            {
+                std::memcpy(out, file.get_data() + header.data_offset, rows * sizeof(double));
+                this->hits++;
+                return true;
+            }
+        }
+    }
+    catch (const std::runtime_error &)
+    {
+    }
+    this->misses++;
+    return false;
+}
+
+void FeatureCache::store(uint64_t key, const double *values, size_t rows) const
+{
+    FeatureCacheHeader header{};
+    std::memcpy(header.magic, FEATURE_CACHE_MAGIC, sizeof(header.magic));
+    header.version = FEATURE_CACHE_VERSION;
+    header.key = key;
+    header.rows = rows;
+    header.data_offset = (sizeof(header) + FEATURE_CACHE_ALIGNMENT - 1) & ~(FEATURE_CACHE_ALIGNMENT - 1);
+
+    // write to a file private to this thread and move it into place in one step
+    auto path = this->entry_path(key);
+    auto temp_path = fmt::format("{}.{}.{}.tmp", path, getpid(), std::hash<std::thread::id>()(std::this_thread::get_id()));
+    {
+        ofstream file(temp_path, ios::binary | ios::trunc);
+        if (!file)
+        {
+            ARGUS_RUNTIME_ERROR(fmt::format("failed to open file for writing: {}", temp_path));
+        }
+        static const char zeros[FEATURE_CACHE_ALIGNMENT] = {};
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(zeros, static_cast<streamsize>(header.data_offset - sizeof(header)));
+        file.write(reinterpret_cast<const char *>(values), static_cast<streamsize>(rows * sizeof(double)));
+        if (!file)
+        {
+            ARGUS_RUNTIME_ERROR(fmt::format("failed to write file: {}", temp_path));
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temp_path, path, error);
+    if (error)
+    {
+        std::filesystem::remove(temp_path, error);
+        ARGUS_RUNTIME_ERROR(fmt::format("failed to store feature {}: {}", path, error.message()));
+    }
+}
@@ -1,6 +1,8 @@
 //
 // Created by Nathan Tormaschy on 4/19/23.
 //
+#include <algorithm>
+#include <climits>
 #include <cstddef>
 #include <cstdio>
 #include <iostream>
@@ -45,10 +47,6 @@ Hydra::~Hydra()
 #ifdef DEBUGGING
     printf("MEMORY:   deallocating hydra at : %p \n", this);
 #endif
-    if (this->is_built)
-    {
-        delete[] this->datetime_index;
-    }
 }
 
 #ifdef ARGUS_STRIP
@@ -104,18 +102,11 @@ void Hydra::reset(bool clear_history, bool clear_strategies)
 
 void Hydra::build()
 {
-    // check to see if the exchange has been built before
-    if (this->is_built)
-    {
-        delete[] this->datetime_index;
-    }
     if (this->exchange_map->exchanges.empty())
     {
         throw std::runtime_error("no exchanges to build");
     }
 
-    this->datetime_index = new long long[0];
-    this->datetime_index_length = 0;
     this->candles = 0;
 
     // build the exchanges
@@ -130,6 +121,26 @@ void Hydra::build()
         }
     }
 
+    // place every asset buffer into one 64 byte aligned arena, each exchange's assets back to back
+    size_t arena_request = 0;
+    for (auto it = this->exchange_map->exchanges.begin(); it != this->exchange_map->exchanges.end(); ++it)
+    {
+        arena_request += it->second->get_arena_request();
+    }
+    if (arena_request)
+    {
+        this->arena = make_shared<Arena>(arena_request, this->huge_pages);
+        for (auto it = this->exchange_map->exchanges.begin(); it != this->exchange_map->exchanges.end(); ++it)
+        {
+            it->second->move_assets_to_arena(this->arena);
+        }
+    }
+    else
+    {
+        // assets moved by an earlier build keep that arena alive on their own
+        this->arena = nullptr;
+    }
+
     // build the brokers
     for (auto it = this->brokers->begin(); it != this->brokers->end(); ++it)
     {
@@ -144,15 +155,97 @@ void Hydra::build()
         [](const shared_ptr<Exchange> &obj)
         { return obj->get_rows(); });
 
-    this->datetime_index = get<0>(datetime_index_);
-    this->datetime_index_length = get<1>(datetime_index_);
+    // share the index with the exchange if there is only one
+    this->datetime_index_sp = intern_datetime_index(std::move(datetime_index_));
+    this->datetime_index = this->datetime_index_sp->get_data();
+    this->datetime_index_length = this->datetime_index_sp->get_size();
 
     //build portfolios with given size
     this->master_portfolio->build(this->datetime_index_length);
+    this->build_exchange_schedule();
 
     this->is_built = true;
 };
 
+void Hydra::build_exchange_schedule()
+{
+    // count the exchanges with a bar at each position, every exchange's index is a subset of the hydra's
+    this->exchange_schedule_offsets.assign(this->datetime_index_length + 1, 0);
+    auto walk_exchange = [&](Exchange *exchange, auto &&on_position)
+    {
+        auto exchange_index = exchange->get_datetime_index();
+        size_t position = 0;
+        for(size_t i = 0; i < exchange->get_rows(); i++)
+        {
+            position = this->datetime_index_sp->lower_bound(exchange_index[i], position);
+            on_position(position);
+        }
+    };
+    for (auto &exchange_pair : this->exchange_map->exchanges)
+    {
+        walk_exchange(exchange_pair.second.get(), [&](size_t position){ this->exchange_schedule_offsets[position + 1]++; });
+    }
+    for (size_t i = 0; i < this->datetime_index_length; i++)
+    {
+        this->exchange_schedule_offsets[i + 1] += this->exchange_schedule_offsets[i];
+    }
+
+    // fill each position's slice, offsets are used as cursors and shifted back once every slot is filled
+    this->exchange_schedule.resize(this->exchange_schedule_offsets.back());
+    for (auto &exchange_pair : this->exchange_map->exchanges)
+    {
+        auto exchange = exchange_pair.second.get();
+        walk_exchange(exchange, [&](size_t position){ this->exchange_schedule[this->exchange_schedule_offsets[position]++] = exchange; });
+    }
+    for (size_t i = this->datetime_index_length; i > 0; i--)
+    {
+        this->exchange_schedule_offsets[i] = this->exchange_schedule_offsets[i - 1];
+    }
+    this->exchange_schedule_offsets[0] = 0;
+}
+
+void Hydra::extend()
+{
+    if (!this->is_built)
+    {
+        throw std::runtime_error("hydra must be built before it is extended");
+    }
+
+    // extend the exchanges, collecting the timestamps added to any of them
+    auto streamed_until = this->current_index ? this->datetime_index[this->current_index - 1] : LLONG_MIN;
+    vector<long long> added;
+    this->candles = 0;
+    for (auto it = this->exchange_map->exchanges.begin(); it != this->exchange_map->exchanges.end(); ++it)
+    {
+        auto exchange_added = it->second->extend(streamed_until);
+        added.insert(added.end(), exchange_added.begin(), exchange_added.end());
+        this->candles += it->second->candles;
+    }
+    std::sort(added.begin(), added.end());
+    added.erase(std::unique(added.begin(), added.end()), added.end());
+
+    // merge the new timestamps into the combined index, exchanges can share timestamps with each other
+    vector<long long> extended_index;
+    extended_index.reserve(this->datetime_index_length + added.size());
+    std::set_union(
+        this->datetime_index, this->datetime_index + this->datetime_index_length,
+        added.begin(), added.end(),
+        std::back_inserter(extended_index));
+    if (extended_index.size() == this->datetime_index_length)
+    {
+        // an exchange can gain timestamps another exchange already had
+        this->build_exchange_schedule();
+        return;
+    }
+    this->datetime_index_sp = intern_datetime_index(std::move(extended_index));
+    this->datetime_index = this->datetime_index_sp->get_data();
+    this->datetime_index_length = this->datetime_index_sp->get_size();
+
+    // tracers keep their history, they only reserve room for the new rows
+    this->master_portfolio->build(this->datetime_index_length);
+    this->build_exchange_schedule();
+}
+
 shared_ptr<Portfolio> Hydra::get_portfolio(const string& portfolio_id){
     if(portfolio_id == this->master_portfolio->get_portfolio_id()){
         return this->master_portfolio;
@@ -323,18 +416,18 @@ void Hydra::forward_pass()
     }
     #endif
 
-    // build market views for exchanges
+    // build market views for the exchanges with a bar at this time
+    auto schedule_start = this->exchange_schedule_offsets[this->current_index];
+    auto schedule_end = this->exchange_schedule_offsets[this->current_index + 1];
+    for (auto i = schedule_start; i < schedule_end; i++)
+    {
+        this->exchange_schedule[i]->get_market_view();
+    }
+
     for (auto &exchange_pair : this->exchange_map->exchanges)
     {
-        auto exchange = exchange_pair.second;
         // set the exchange is_close
-        exchange->set_on_close(false);
-
-        // if the exchange time is equal to the hydra time then build market view
-        if (exchange->get_datetime() == this->hydra_time)
-        {
-            auto exchange_steaming = exchange->get_market_view();
-        }
+        exchange_pair.second->set_on_close(false);
 
         // allow exchanges to process open orders
         exchange_pair.second->process_orders();
@@ -577,28 +670,19 @@ void Hydra::goto_datetime(long long datetime)
         throw std::runtime_error("hydra must be build first");
     }
 
-    // move exchanges forward in time
-    for(auto& exchange_pair : this->exchange_map->exchanges)
-    {
-        exchange_pair.second->goto_datetime(datetime);
-    }
-
-    // move the indivual asssets forward in time
-    for(auto& asset_pair : this->exchange_map->asset_map)
+    // next bar is the first one at or after the datetime, forward or backward in time
+    auto position = this->datetime_index_sp->lower_bound(datetime);
+    if(position == this->datetime_index_length)
     {
-        asset_pair.second->goto_datetime(datetime);
+        throw runtime_error("failed to find datetime in hydra index");
     }
+    this->current_index = position;
 
-    // move the hydra index forward in time
-    for(int i = 0; i < this->datetime_index_length; i++)
+    // exchanges move their assets and market views to the same point in time
+    for(auto& exchange_pair : this->exchange_map->exchanges)
     {
-        if(this->datetime_index[i] == datetime)
-        {
-            this->current_index = i;
-            return;
-        }
+        exchange_pair.second->goto_datetime(datetime);
     }
-    throw runtime_error("failed to find datetime in hydra index");
 }
 
 void Hydra::run(long long to, size_t steps){
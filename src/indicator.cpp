@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+
+#include "indicator.h"
+
+using namespace std;
+
+size_t indicator_input_count(IndicatorType type)
+{
+    return type == Atr ? 3 : 1;
+}
+
+OnlineIndicator::OnlineIndicator(IndicatorType type_, size_t window_) : type(type_), window(window_)
+{
+    if (window_ == 0)
+    {
+        throw std::runtime_error("indicator window must be greater than 0");
+    }
+    this->reset();
+}
+
+void OnlineIndicator::reset()
+{
+    this->value = NAN;
+    this->count = 0;
+    this->nan_count = 0;
+    this->valid_count = 0;
+    this->mean = 0;
+    this->m2 = 0;
+    this->numerator = 0;
+    this->denominator = 0;
+    this->previous_close = NAN;
+    this->extremes.clear();
+
+    // only rolling windows need the inputs of the last window rows
+    auto is_rolling = this->type == Sma || this->type == Variance || this->type == Minimum || this->type == Maximum;
+    this->history.assign(is_rolling ? this->window : 0, NAN);
+}
+
+void OnlineIndicator::update(const double *values)
+{
+    switch (this->type)
+    {
+    case Sma:
+    case Variance:
+        this->update_moments(values[0]);
+        break;
+    case Minimum:
+        this->update_extreme(values[0], true);
+        break;
+    case Maximum:
+        this->update_extreme(values[0], false);
+        break;
+    case Ema:
+        this->update_ema(values[0]);
+        break;
+    case Atr:
+        this->update_atr(values[0], values[1], values[2]);
+        break;
+    }
+    this->count++;
+}
+
+void OnlineIndicator::update_moments(double input)
+{
+    // welford's running mean and sum of squared deviations with the oldest row removed once the
+    // window is full, nan values are left out of the sums and poison every window they are in
+    auto slot = this->count % this->window;
+    if (this->count >= this->window)
+    {
+        auto removed = this->history[slot];
+        if (std::isnan(removed))
+        {
+            this->nan_count--;
+        }
+        else if (--this->valid_count == 0)
+        {
+            this->mean = 0;
+            this->m2 = 0;
+        }
+        else
+        {
+            auto delta = removed - this->mean;
+            this->mean -= delta / this->valid_count;
+            this->m2 -= delta * (removed - this->mean);
+        }
+    }
+    this->history[slot] = input;
+    if (std::isnan(input))
+    {
+        this->nan_count++;
+    }
+    else
+    {
+        this->valid_count++;
+        auto delta = input - this->mean;
+        this->mean += delta / this->valid_count;
+        this->m2 += delta * (input - this->mean);
+    }
+
+    if (this->count + 1 < this->window || this->nan_count)
+    {
+        this->value = NAN;
+    }
+    else if (this->type == Sma)
+    {
+        this->value = this->mean;
+    }
+    else
+    {
+        this->value = this->window > 1 ? std::max(this->m2, 0.0) / (this->window - 1) : NAN;
+    }
+}
+
+void OnlineIndicator::update_extreme(double input, bool is_minimum)
+{
+    // monotonic deque of rows, the front is the extreme of the window and every row behind it
+    // is a later row that could become the extreme once the rows in front of it leave the window
+    auto slot = this->count % this->window;
+    if (this->count >= this->window)
+    {
+        if (std::isnan(this->history[slot]))
+        {
+            this->nan_count--;
+        }
+        if (!this->extremes.empty() && this->extremes.front() == this->count - this->window)
+        {
+            this->extremes.pop_front();
+        }
+    }
+    if (std::isnan(input))
+    {
+        this->nan_count++;
+    }
+    else
+    {
+        while (!this->extremes.empty())
+        {
+            auto back = this->history[this->extremes.back() % this->window];
+            if (is_minimum ? back < input : back > input)
+            {
+                break;
+            }
+            this->extremes.pop_back();
+        }
+        this->extremes.push_back(this->count);
+    }
+    this->history[slot] = input;
+
+    if (this->count + 1 < this->window || this->nan_count)
+    {
+        this->value = NAN;
+    }
+    else
+    {
+        this->value = this->history[this->extremes.front() % this->window];
+    }
+}
+
+void OnlineIndicator::update_ema(double input)
+{
+    // adjusted exponentially weighted mean, nan values decay the weights but add nothing
+    auto decay = 1.0 - 2.0 / (this->window + 1.0);
+    this->numerator *= decay;
+    this->denominator *= decay;
+    if (!std::isnan(input))
+    {
+        this->numerator += input;
+        this->denominator += 1;
+    }
+    this->value = this->denominator > 0 ? this->numerator / this->denominator : NAN;
+}
+
+void OnlineIndicator::update_atr(double high, double low, double close)
+{
+    // true range includes the gap from the previous close, the first row only has its own range
+    auto true_range = high - low;
+    if (!std::isnan(this->previous_close))
+    {
+        true_range = std::max({true_range, std::fabs(high - this->previous_close), std::fabs(low - this->previous_close)});
+    }
+    if (!std::isnan(close))
+    {
+        this->previous_close = close;
+    }
+
+    // rows with a missing price leave the average as it was
+    if (std::isnan(true_range))
+    {
+        this->value = NAN;
+        return;
+    }
+
+    // wilder's smoothing seeded with the mean of the first window true ranges
+    this->valid_count++;
+    if (this->valid_count <= this->window)
+    {
+        this->numerator += true_range;
+        this->mean = this->numerator / this->valid_count;
+        this->value = this->valid_count == this->window ? this->mean : NAN;
+    }
+    else
+    {
+        this->mean = (this->mean * (this->window - 1) + true_range) / this->window;
+        this->value = this->mean;
+    }
+}
@@ -10,6 +10,11 @@
 
 #include "account.h"
 #include "asset.h"
+#include "asset_file.h"
+#include "asset_stream.h"
+#include "csv_reader.h"
+#include "feather_reader.h"
+#include "feature_cache.h"
 #include "broker.h"
 #include "exchange.h"
 #include "hydra.h"
@@ -24,13 +29,80 @@ using namespace std;
 
 void init_asset_ext(py::module &m)
 {
+    py::class_<ValidationCheck>(m, "ValidationCheck")
+        .def_readonly("count", &ValidationCheck::count)
+        .def_readonly("first_row", &ValidationCheck::first_row)
+        .def("passed", &ValidationCheck::passed);
+
+    py::class_<FeatureCache, std::shared_ptr<FeatureCache>>(m, "FeatureCache")
+        .def("get_dir_path", &FeatureCache::get_dir_path)
+        .def("get_hits", &FeatureCache::get_hits)
+        .def("get_misses", &FeatureCache::get_misses);
+
+    py::class_<Schema, std::shared_ptr<Schema>>(m, "Schema")
+        .def("get_columns", &Schema::get_columns)
+        .def("get_size", &Schema::get_size)
+        .def("has_column", &Schema::has_column);
+
+    py::class_<AssetValidationReport>(m, "AssetValidationReport")
+        .def_readonly("asset_id", &AssetValidationReport::asset_id)
+        .def_readonly("rows", &AssetValidationReport::rows)
+        .def_readonly("is_checked", &AssetValidationReport::is_checked)
+        .def_readonly("prices_checked", &AssetValidationReport::prices_checked)
+        .def_readonly("unsorted", &AssetValidationReport::unsorted)
+        .def_readonly("duplicates", &AssetValidationReport::duplicates)
+        .def_readonly("invalid_open", &AssetValidationReport::invalid_open)
+        .def_readonly("invalid_close", &AssetValidationReport::invalid_close)
+        .def("is_valid", &AssetValidationReport::is_valid)
+        .def("__repr__", &AssetValidationReport::to_string);
+
     py::class_<Asset, std::shared_ptr<Asset>>(m, "Asset")
         .def("get_asset_id", &Asset::get_asset_id)
         .def("load_headers", &Asset::load_headers)
-        .def("load_data", &Asset::py_load_data)
+        .def("load_data", &Asset::py_load_data,
+            py::arg("data"),
+            py::arg("datetime_index"),
+            py::arg("rows"),
+            py::arg("cols"),
+            py::arg("is_view"),
+            py::arg("column_major") = false)
+        .def("append_rows", &Asset::py_append_rows,
+            py::arg("data"),
+            py::arg("datetime_index"),
+            py::arg("rows"))
+        .def("set_column_type", &Asset::set_column_type,
+            py::arg("column"),
+            py::arg("column_type"),
+            py::arg("scale") = 1.0)
+        .def("resample", &Asset::resample,
+            py::arg("interval"),
+            py::arg("asset_id"))
+        .def("add_indicator", &Asset::add_indicator,
+            py::arg("name"),
+            py::arg("indicator_type"),
+            py::arg("columns"),
+            py::arg("window"))
         .def("get", &Asset::get)
+        .def("get_asset_feature",
+            py::overload_cast<const string &, int>(&Asset::get_asset_feature),
+            py::arg("column_name"),
+            py::arg("index") = 0)
+        .def("get_asset_feature",
+            py::overload_cast<size_t, int>(&Asset::get_asset_feature),
+            py::arg("column_index"),
+            py::arg("index") = 0)
+        .def("get_column_index", &Asset::get_column_index)
+        .def("get_schema", &Asset::get_schema)
         .def("get_mem_address", &Asset::get_mem_address)
         .def("get_column", &Asset::get_column)
+        .def_readonly("is_column_major", &Asset::is_column_major)
+        .def_readonly("is_alligned", &Asset::is_alligned)
+        .def_readonly("exchange_offset", &Asset::exchange_offset)
+        .def("get_is_compact", &Asset::get_is_compact)
+        .def("get_is_resident", &Asset::get_is_resident)
+        .def("get_is_stream", &Asset::get_is_stream)
+        .def("validate", &Asset::validate)
+        .def("get_validation_report", &Asset::get_validation_report)
 
         //.def("mem_address", []()
         .def("get_datetime_index_view",
@@ -44,6 +116,64 @@ void init_asset_ext(py::module &m)
             py::arg("warmup") = 0
     );
 
+    m.def("write_asset_file", &write_asset_file,
+            py::arg("asset"),
+            py::arg("path")
+    );
+
+    m.def("read_asset_file", &read_asset_file,
+            py::arg("path"),
+            py::arg("asset_id"),
+            py::arg("exchange_id"),
+            py::arg("broker_id"),
+            py::arg("warmup") = 0,
+            py::arg("prefetch") = false
+    );
+
+    m.def("open_asset_stream", &open_asset_stream,
+            py::arg("path"),
+            py::arg("asset_id"),
+            py::arg("exchange_id"),
+            py::arg("broker_id"),
+            py::arg("warmup") = 0,
+            py::arg("chunk_rows") = 65536,
+            py::arg("lookback") = 256,
+            py::call_guard<py::gil_scoped_release>()
+    );
+
+    m.def("read_csv_file", &read_csv_file,
+            py::arg("path"),
+            py::arg("asset_id"),
+            py::arg("exchange_id"),
+            py::arg("broker_id"),
+            py::arg("warmup") = 0,
+            py::arg("datetime_column") = "",
+            py::arg("epoch_unit") = "ns",
+            py::arg("delimiter") = ',',
+            py::arg("threads") = 1,
+            py::call_guard<py::gil_scoped_release>()
+    );
+
+    m.def("read_feather_file", &read_feather_file,
+            py::arg("path"),
+            py::arg("asset_id"),
+            py::arg("exchange_id"),
+            py::arg("broker_id"),
+            py::arg("warmup") = 0,
+            py::arg("datetime_column") = "",
+            py::arg("epoch_unit") = "ns",
+            py::call_guard<py::gil_scoped_release>()
+    );
+
+    m.def("load_asset_file", &load_asset_file,
+            py::arg("path"),
+            py::arg("asset_id"),
+            py::arg("exchange_id"),
+            py::arg("broker_id"),
+            py::arg("warmup") = 0,
+            py::call_guard<py::gil_scoped_release>()
+    );
+
     // Define a function that returns the memory address of a MyClass instance
     m.def("mem_address", [](Asset &instance)
           { return reinterpret_cast<std::uintptr_t>(&instance); });
@@ -53,9 +183,36 @@ void init_exchange_ext(py::module &m)
 {
     py::class_<Exchange, std::shared_ptr<Exchange>>(m, "Exchange")
         .def("build", &Exchange::build)
+        .def("extend", &Exchange::extend,
+            py::arg("streamed_until") = LLONG_MIN)
         .def("new_asset", &Exchange::new_asset)
         .def("register_asset", &Exchange::register_asset)
+        .def("register_assets_from_files", &Exchange::register_assets_from_files,
+            py::arg("paths"),
+            py::arg("broker_id"),
+            py::arg("warmup") = 0,
+            py::arg("threads") = 0,
+            py::call_guard<py::gil_scoped_release>())
+        .def("register_assets_from_dir", &Exchange::register_assets_from_dir,
+            py::arg("dir_path"),
+            py::arg("broker_id"),
+            py::arg("warmup") = 0,
+            py::arg("threads") = 0,
+            py::call_guard<py::gil_scoped_release>())
+        .def("register_lazy_asset", &Exchange::register_lazy_asset,
+            py::arg("asset_id"),
+            py::arg("broker_id"),
+            py::arg("loader"))
+        .def("register_lazy_assets_from_files", &Exchange::register_lazy_assets_from_files,
+            py::arg("paths"),
+            py::arg("broker_id"),
+            py::arg("warmup") = 0)
+        .def("register_lazy_assets_from_dir", &Exchange::register_lazy_assets_from_dir,
+            py::arg("dir_path"),
+            py::arg("broker_id"),
+            py::arg("warmup") = 0)
         
+        .def("get_is_index_regular", &Exchange::get_is_index_regular)
         .def("get_asset", &Exchange::get_asset, py::return_value_policy::reference)
         .def("get_exchange_feature", 
             &Exchange::get_exchange_feature, 
@@ -70,6 +227,15 @@ void init_exchange_ext(py::module &m)
             py::arg("column_name"),
             py::arg("index") = 0)
 
+        .def("get_arena_size", &Exchange::get_arena_size)
+        .def("get_validation_reports", &Exchange::get_validation_reports)
+        .def("get_schema", &Exchange::get_schema)
+        .def("add_derived_column", &Exchange::add_derived_column,
+            py::arg("name"),
+            py::arg("expression"))
+        .def("set_feature_cache", &Exchange::set_feature_cache,
+            py::arg("dir_path"))
+        .def("get_feature_cache", &Exchange::get_feature_cache)
         .def("get_datetime_index_view", &Exchange::get_datetime_index_view);
 }
 
@@ -82,6 +248,7 @@ void init_hydra_ext(py::module &m)
                     return py::capsule(ptr, "void*");
                 })
         .def("build", &Hydra::build)
+        .def("extend", &Hydra::extend)
         .def("run", &Hydra::run,
             py::arg("steps") = 0,
             py::arg("to") = 0)
@@ -107,6 +274,8 @@ void init_hydra_ext(py::module &m)
         .def("get_datetime_index_view", &Hydra::get_datetime_index_view)
         .def("get_order_history", &Hydra::get_order_history)
         .def("get_candles", &Hydra::get_candles)
+        .def("set_huge_pages", &Hydra::set_huge_pages)
+        .def("get_arena_size", &Hydra::get_arena_size)
         .def("get_broker", &Hydra::get_broker)
         .def("get_master_portfolio", &Hydra::get_master_portflio)
         .def("get_portfolio", &Hydra::get_portfolio)
@@ -262,6 +431,21 @@ void init_enum(py::module &m){
         .value("EVENT", PortfolioTracerType::Event)
         .export_values();
 
+    py::enum_<AssetColumnType>(m, "AssetColumnType")
+        .value("FLOAT64", AssetColumnType::Float64)
+        .value("FLOAT32", AssetColumnType::Float32)
+        .value("SCALED_INT32", AssetColumnType::ScaledInt32)
+        .export_values();
+
+    py::enum_<IndicatorType>(m, "IndicatorType")
+        .value("SMA", IndicatorType::Sma)
+        .value("EMA", IndicatorType::Ema)
+        .value("VARIANCE", IndicatorType::Variance)
+        .value("MINIMUM", IndicatorType::Minimum)
+        .value("MAXIMUM", IndicatorType::Maximum)
+        .value("ATR", IndicatorType::Atr)
+        .export_values();
+
     py::enum_<ExchangeQueryType>(m, "ExchangeQueryType")
         .value("DEFAULT", ExchangeQueryType::Default)
         .value("NLARGEST", ExchangeQueryType::NLargest)
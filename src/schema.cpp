@@ -0,0 +1,55 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "fmt/core.h"
+
+#include "intern_pool.h"
+#include "schema.h"
+
+using namespace std;
+
+/// schemas alive, shared by every asset with the same columns
+static InternPool<Schema> schema_pool;
+
+Schema::Schema(vector<string> columns_) : columns(std::move(columns_))
+{
+    this->indices.reserve(this->columns.size());
+    for (size_t j = 0; j < this->columns.size(); j++)
+    {
+        if (!this->indices.emplace(this->columns[j], j).second)
+        {
+            throw std::runtime_error(fmt::format("duplicate column {}", this->columns[j]));
+        }
+    }
+    this->hash = hash_schema(this->columns);
+}
+
+size_t hash_schema(const vector<string> &columns)
+{
+    // combine the hashes of the names in order, seeded with the number of columns
+    size_t hash = columns.size();
+    for (const auto &column : columns)
+    {
+        hash ^= std::hash<string>()(column) + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+}
+
+schema_sp_t intern_schema(const vector<string> &columns)
+{
+    return schema_pool.intern(
+        hash_schema(columns),
+        [&columns](const Schema &schema) { return schema.get_columns() == columns; },
+        [&columns]() { return make_shared<const Schema>(columns); });
+}
+
+size_t get_interned_schema_count()
+{
+    return schema_pool.size();
+}
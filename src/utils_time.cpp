@@ -6,6 +6,11 @@
 #include <chrono>
 #include <ctime>
 
+#include "fmt/core.h"
+
+#include "settings.h"
+#include "utils_time.h"
+
 std::string nanosecond_epoch_time_to_string(long long ns_epoch_time) {
     // Define the epoch time for the system clock
     std::chrono::system_clock::time_point sys_epoch_time;
@@ -31,3 +36,16 @@ std::string nanosecond_epoch_time_to_string(long long ns_epoch_time) {
 
     return str;
 }
+
+long long epoch_unit_scale(const std::string &epoch_unit)
+{
+    if (epoch_unit == "s")
+        return 1000000000LL;
+    if (epoch_unit == "ms")
+        return 1000000LL;
+    if (epoch_unit == "us")
+        return 1000LL;
+    if (epoch_unit == "ns")
+        return 1LL;
+    ARGUS_RUNTIME_ERROR(fmt::format("invalid epoch unit: {}, expected one of s, ms, us, ns", epoch_unit));
+}